@@ -0,0 +1,63 @@
+#include "../pgoutput/text_decoders.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+
+namespace {
+constexpr std::array<std::string_view, 4> int8Values = {
+    "42", "-1234567", "9876543210123", "-123456789012345"
+};
+constexpr std::array<std::string_view, 4> timestampValues = {
+    "2024-01-02 03:04:05", "2024-01-02 03:04:05.123456+00",
+    "1999-12-31 23:59:59.5-08", "2030-06-15 12:00:00+05:30"
+};
+constexpr std::array<std::string_view, 2> uuidValues = {
+    "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11",
+    "123E4567-E89B-12D3-A456-426614174000"
+};
+
+template <typename T, std::size_t Size>
+void decodeTextValues(benchmark::State &state, SimdLevel level,
+                      const std::array<std::string_view, Size> &values) {
+    const auto previous = textDecoderSimdLevel();
+    setTextDecoderSimdLevel(level);
+    if (textDecoderSimdLevel() != level) {
+        state.SkipWithError("SIMD level not supported by this CPU");
+    };
+    for (auto _ : state) {
+        for (const auto &value : values) {
+            auto result = decodeText<T>(value);
+            benchmark::DoNotOptimize(result);
+        };
+    };
+    state.SetItemsProcessed(state.iterations() * values.size());
+    setTextDecoderSimdLevel(previous);
+};
+
+void decodeInt8(benchmark::State &state, SimdLevel level) {
+    decodeTextValues<std::int64_t>(state, level, int8Values);
+};
+
+void decodeTimestamp(benchmark::State &state, SimdLevel level) {
+    decodeTextValues<Timestamp>(state, level, timestampValues);
+};
+
+void decodeUuid(benchmark::State &state, SimdLevel level) {
+    decodeTextValues<Uuid>(state, level, uuidValues);
+};
+};  // namespace
+
+BENCHMARK_CAPTURE(decodeInt8, scalar, SimdLevel::SCALAR);
+BENCHMARK_CAPTURE(decodeInt8, sse42, SimdLevel::SSE42);
+BENCHMARK_CAPTURE(decodeTimestamp, scalar, SimdLevel::SCALAR);
+BENCHMARK_CAPTURE(decodeTimestamp, sse42, SimdLevel::SSE42);
+BENCHMARK_CAPTURE(decodeUuid, scalar, SimdLevel::SCALAR);
+BENCHMARK_CAPTURE(decodeUuid, sse42, SimdLevel::SSE42);
+BENCHMARK_CAPTURE(decodeUuid, avx2, SimdLevel::AVX2);
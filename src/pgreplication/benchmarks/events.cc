@@ -0,0 +1,100 @@
+#include "../events.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include "../copy_data.hpp"
+#include "./workloads.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::benchmarks;
+
+namespace {
+void primaryEventFromNetworkBuffer(benchmark::State &state,
+                                   std::vector<char> message) {
+    for (auto _ : state) {
+        auto result = PGREPLICATION_NAMESPACE::primaryEventFromNetworkBuffer(
+            message);
+        benchmark::DoNotOptimize(result);
+    };
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * message.size());
+};
+
+void primaryEventToNetworkBuffer(benchmark::State &state,
+                                 std::vector<char> walData) {
+    const auto &event = PrimaryEvent(
+        XLogData{ .messageWalStart = 1,
+                  .serverWalEnd = 2,
+                  .sentAtUnixTimestamp = 3,
+                  .walData = std::span<char>(walData) });
+    for (auto _ : state) {
+        auto buffer =
+            PGREPLICATION_NAMESPACE::primaryEventToNetworkBuffer(event);
+        benchmark::DoNotOptimize(buffer);
+    };
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() *
+                            primaryEventNetworkSize(event));
+};
+
+void primaryEventToCopyData(benchmark::State &state,
+                            std::vector<char> walData) {
+    const auto &event = PrimaryEvent(
+        XLogData{ .messageWalStart = 1,
+                  .serverWalEnd = 2,
+                  .sentAtUnixTimestamp = 3,
+                  .walData = std::span<char>(walData) });
+    std::vector<char> buffer(CopyDataFramer::headerSize +
+                             primaryEventNetworkSize(event));
+    for (auto _ : state) {
+        auto result = PGREPLICATION_NAMESPACE::primaryEventToCopyData(event,
+                                                                      buffer);
+        benchmark::DoNotOptimize(result);
+        benchmark::ClobberMemory();
+    };
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+};
+
+void copyDataFramer(benchmark::State &state, std::vector<char> walData) {
+    const auto &event = PrimaryEvent(
+        XLogData{ .messageWalStart = 1,
+                  .serverWalEnd = 2,
+                  .sentAtUnixTimestamp = 3,
+                  .walData = std::span<char>(walData) });
+    const auto &messageSize =
+        CopyDataFramer::headerSize + primaryEventNetworkSize(event);
+    std::vector<char> stream(messageSize * 64);
+    for (std::size_t index = 0; index < 64; index++) {
+        (void)PGREPLICATION_NAMESPACE::primaryEventToCopyData(
+            event, std::span(stream).subspan(index * messageSize));
+    };
+    CopyDataFramer framer(stream.size());
+    for (auto _ : state) {
+        framer.feed(stream);
+        while (true) {
+            auto result = framer.next();
+            if (!result.has_value() || !result.value().has_value()) break;
+            benchmark::DoNotOptimize(result);
+        };
+    };
+    state.SetItemsProcessed(state.iterations() * 64);
+    state.SetBytesProcessed(state.iterations() * stream.size());
+};
+};  // namespace
+
+BENCHMARK_CAPTURE(primaryEventFromNetworkBuffer, xlogdata_narrow_insert,
+                  buildXLogData(buildInsert(4, false)));
+BENCHMARK_CAPTURE(primaryEventFromNetworkBuffer, xlogdata_wide_insert,
+                  buildXLogData(buildInsert(64, false)));
+BENCHMARK_CAPTURE(primaryEventToNetworkBuffer, xlogdata_wide_insert,
+                  buildInsert(64, false));
+BENCHMARK_CAPTURE(primaryEventToCopyData, xlogdata_wide_insert,
+                  buildInsert(64, false));
+BENCHMARK_CAPTURE(copyDataFramer, xlogdata_wide_insert,
+                  buildInsert(64, false));
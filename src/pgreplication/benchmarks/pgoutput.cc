@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../pgoutput/arena.hpp"
+#include "../pgoutput/pgoutput.hpp"
+#include "./workloads.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::benchmarks;
+
+namespace {
+template <BinaryValue Binary, StreamingValue Streaming,
+          TupleStorageValue Storage = TupleStorageValue::OWNED,
+          ValidationValue Validation = ValidationValue::HARDENED>
+using BenchContext = SessionContext<Binary, MessagesValue::OFF, Streaming,
+                                    TwoPhaseValue::OFF, OriginValue::NONE,
+                                    Storage, Validation>;
+
+template <typename Context>
+void parseEvent(benchmark::State &state, std::vector<char> message) {
+    for (auto _ : state) {
+        auto result = Context::parseEvent(message);
+        benchmark::DoNotOptimize(result);
+    };
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * message.size());
+};
+
+template <typename Context>
+void parseEventInArena(benchmark::State &state, std::vector<char> message) {
+    TransactionArena<Context> arena;
+    for (auto _ : state) {
+        auto result = arena.parseEvent(message);
+        benchmark::DoNotOptimize(result);
+        arena.release();
+    };
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * message.size());
+};
+
+using Text = BenchContext<BinaryValue::OFF, StreamingValue::OFF>;
+using Binary = BenchContext<BinaryValue::ON, StreamingValue::OFF>;
+using TextStreaming = BenchContext<BinaryValue::OFF, StreamingValue::ON>;
+using TextBorrowed = BenchContext<BinaryValue::OFF, StreamingValue::OFF,
+                                  TupleStorageValue::BORROWED>;
+using TextLazy = BenchContext<BinaryValue::OFF, StreamingValue::OFF,
+                              TupleStorageValue::LAZY>;
+using TextPacked = BenchContext<BinaryValue::OFF, StreamingValue::OFF,
+                                TupleStorageValue::PACKED>;
+using TextArena = BenchContext<BinaryValue::OFF, StreamingValue::OFF,
+                               TupleStorageValue::ARENA>;
+using TextTrusted =
+    BenchContext<BinaryValue::OFF, StreamingValue::OFF,
+                 TupleStorageValue::OWNED, ValidationValue::TRUSTED>;
+using BinaryTrusted =
+    BenchContext<BinaryValue::ON, StreamingValue::OFF,
+                 TupleStorageValue::OWNED, ValidationValue::TRUSTED>;
+using TextBorrowedTrusted =
+    BenchContext<BinaryValue::OFF, StreamingValue::OFF,
+                 TupleStorageValue::BORROWED, ValidationValue::TRUSTED>;
+
+// BENCHMARK_CAPTURE cannot take a template-id, so the parse workloads are
+// registered explicitly.
+[[maybe_unused]] const auto registered = [] {
+    benchmark::RegisterBenchmark("parseEvent/narrow_insert_text",
+                                 parseEvent<Text>, buildInsert(4, false));
+    benchmark::RegisterBenchmark("parseEvent/wide_insert_text",
+                                 parseEvent<Text>, buildInsert(64, false));
+    benchmark::RegisterBenchmark("parseEvent/narrow_insert_binary",
+                                 parseEvent<Binary>, buildInsert(4, true));
+    benchmark::RegisterBenchmark("parseEvent/wide_insert_binary",
+                                 parseEvent<Binary>, buildInsert(64, true));
+    benchmark::RegisterBenchmark("parseEvent/wide_insert_text_streaming",
+                                 parseEvent<TextStreaming>,
+                                 buildInsert(64, false, 1234));
+    benchmark::RegisterBenchmark("parseEvent/update_with_key_text",
+                                 parseEvent<Text>,
+                                 buildUpdateWithKey(16, false));
+    benchmark::RegisterBenchmark("parseEvent/update_with_key_binary",
+                                 parseEvent<Binary>,
+                                 buildUpdateWithKey(16, true));
+    benchmark::RegisterBenchmark("parseEvent/wide_insert_text_borrowed",
+                                 parseEvent<TextBorrowed>,
+                                 buildInsert(64, false));
+    benchmark::RegisterBenchmark("parseEvent/wide_insert_text_lazy",
+                                 parseEvent<TextLazy>, buildInsert(64, false));
+    benchmark::RegisterBenchmark("parseEvent/wide_insert_text_packed",
+                                 parseEvent<TextPacked>,
+                                 buildInsert(64, false));
+    benchmark::RegisterBenchmark("parseEvent/wide_insert_text_trusted",
+                                 parseEvent<TextTrusted>,
+                                 buildInsert(64, false));
+    benchmark::RegisterBenchmark("parseEvent/update_with_key_binary_trusted",
+                                 parseEvent<BinaryTrusted>,
+                                 buildUpdateWithKey(16, true));
+    benchmark::RegisterBenchmark(
+        "parseEvent/wide_insert_text_borrowed_trusted",
+        parseEvent<TextBorrowedTrusted>, buildInsert(64, false));
+    benchmark::RegisterBenchmark("parseEventInArena/wide_insert_text",
+                                 parseEventInArena<TextArena>,
+                                 buildInsert(64, false));
+    return true;
+}();
+};  // namespace
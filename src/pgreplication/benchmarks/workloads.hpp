@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE::benchmarks {
+using utils::appendInt16;
+using utils::appendInt32;
+using utils::appendInt64;
+
+// Columns cycle through an integer key, a short text value, a timestamp-like
+// value and a NULL, which is roughly what an OLTP table looks like on the
+// wire. Binary tuples carry fixed-width big-endian values instead.
+inline void appendTuple(std::vector<char> &buffer, std::size_t columns,
+                        bool binary, std::int64_t seed) {
+    appendInt16(buffer, columns);
+    for (std::size_t index = 0; index < columns; index++) {
+        if (index % 4 == 3) {
+            buffer.push_back('n');
+            continue;
+        };
+        buffer.push_back(binary ? 'b' : 't');
+        if (binary) {
+            appendInt32(buffer, 8);
+            appendInt64(buffer, seed + index);
+            continue;
+        };
+        const auto &value =
+            index % 4 == 1 ? std::string("customer-") + std::to_string(seed)
+            : index % 4 == 2
+                ? std::string("2024-01-01 12:00:00.") + std::to_string(index)
+                : std::to_string(seed + index);
+        appendInt32(buffer, value.size());
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    };
+};
+
+inline std::vector<char> buildInsert(std::size_t columns, bool binary,
+                                     std::optional<std::int32_t> transactionId =
+                                         std::nullopt) {
+    std::vector<char> buffer = { 'I' };
+    if (transactionId.has_value()) appendInt32(buffer, transactionId.value());
+    appendInt32(buffer, 16384);
+    buffer.push_back('N');
+    appendTuple(buffer, columns, binary, 42);
+    return buffer;
+};
+
+inline std::vector<char> buildUpdateWithKey(std::size_t columns, bool binary) {
+    std::vector<char> buffer = { 'U' };
+    appendInt32(buffer, 16384);
+    buffer.push_back('K');
+    appendTuple(buffer, 1, binary, 42);
+    buffer.push_back('N');
+    appendTuple(buffer, columns, binary, 43);
+    return buffer;
+};
+
+inline std::vector<char> buildXLogData(const std::vector<char> &walData) {
+    std::vector<char> buffer = { 'w' };
+    appendInt64(buffer, 1000);
+    appendInt64(buffer, 2000);
+    appendInt64(buffer, 3000);
+    buffer.insert(buffer.end(), walData.begin(), walData.end());
+    return buffer;
+};
+};  // namespace PGREPLICATION_NAMESPACE::benchmarks
@@ -0,0 +1,214 @@
+#include "./copy_data.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <variant>
+
+#include "./error.hpp"
+#include "./events.hpp"
+#include "./utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE {
+CopyDataFramer::CopyDataFramer(std::size_t capacity)
+    : buffer(std::make_unique_for_overwrite<char[]>(capacity)),
+      bufferCapacity(capacity) {};
+
+void CopyDataFramer::compact() {
+    if (begin == 0) return;
+    std::memmove(buffer.get(), buffer.get() + begin, end - begin);
+    end -= begin;
+    begin = 0;
+};
+
+std::span<char> CopyDataFramer::writable() {
+    if (begin == end) {
+        begin = 0;
+        end = 0;
+    } else if (end == bufferCapacity || begin > bufferCapacity / 2) {
+        compact();
+    };
+    return std::span<char>(buffer.get() + end, bufferCapacity - end);
+};
+
+void CopyDataFramer::commit(std::size_t size) {
+    assert(end + size <= bufferCapacity);
+    end += size;
+};
+
+std::size_t CopyDataFramer::feed(std::span<const char> chunk) {
+    const auto &target = writable();
+    const auto size = std::min(target.size(), chunk.size());
+    std::memcpy(target.data(), chunk.data(), size);
+    commit(size);
+    return size;
+};
+
+void CopyDataFramer::reset() {
+    begin = 0;
+    end = 0;
+};
+
+std::expected<std::optional<CopyFrame>, ParseError> frameCopyData(
+    const std::span<char> &buffer, std::size_t maxFrameSize) {
+    constexpr auto headerSize = CopyDataFramer::headerSize;
+    if (buffer.size() < headerSize) return std::nullopt;
+    const auto &header = buffer.first<headerSize>();
+    const auto &length = utils::int32FromNetwork(header.subspan<1, 4>());
+    if (length < static_cast<std::int32_t>(sizeof(std::int32_t))) {
+        return std::unexpected(
+            ParseError{ .code = ParseErrorCode::INVALID_LENGTH,
+                        .eventType = header[0],
+                        .offset = 1,
+                        .receivedSize = static_cast<std::uint32_t>(length) });
+    };
+    const auto &frameSize = 1 + static_cast<std::size_t>(length);
+    if (frameSize > maxFrameSize) {
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::MESSAGE_TOO_LARGE,
+            .eventType = header[0],
+            .offset = 1,
+            .expectedSize = static_cast<std::uint32_t>(maxFrameSize),
+            .receivedSize = static_cast<std::uint32_t>(frameSize) });
+    };
+    if (buffer.size() < frameSize) return std::nullopt;
+    return CopyFrame{ .type = header[0],
+                      .payload = buffer.subspan(headerSize,
+                                                frameSize - headerSize) };
+};
+
+std::expected<std::optional<CopyFrame>, ParseError>
+CopyDataFramer::nextFrame() {
+    const auto &frame = frameCopyData(
+        std::span<char>(buffer.get() + begin, end - begin), bufferCapacity);
+    if (frame.has_value() && frame.value().has_value()) {
+        begin += headerSize + frame.value().value().payload.size();
+    };
+    return frame;
+};
+
+std::expected<std::optional<PrimaryEvent>, ParseError>
+CopyDataFramer::next() {
+    const auto &frame = nextFrame();
+    if (!frame.has_value()) return std::unexpected(frame.error());
+    if (!frame.value().has_value()) return std::nullopt;
+    const auto &[type, payload] = frame.value().value();
+    if (type != static_cast<char>(CopyMessageType::CopyData)) {
+        return std::unexpected(
+            ParseError{ .code = ParseErrorCode::UNEXPECTED_TYPE,
+                        .eventType = type });
+    };
+    if (payload.empty()) {
+        return std::unexpected(
+            ParseError{ .code = ParseErrorCode::EMPTY_MESSAGE,
+                        .eventType = type,
+                        .offset = headerSize });
+    };
+    return primaryEventFromNetworkBuffer(payload)
+        .transform([](auto &&event) {
+            return std::optional<PrimaryEvent>(std::move(event));
+        })
+        .transform_error([](ParseError error) {
+            error.offset += headerSize;
+            return error;
+        });
+};
+
+std::size_t primaryEventNetworkSize(const PrimaryEvent &event) {
+    return std::visit(
+        utils::overloaded{
+            [](const PrimaryKeepaliveMessage &) -> std::size_t {
+                return 1 + PrimaryKeepaliveMessage::size;
+            },
+            [](const XLogData &data) -> std::size_t {
+                return 1 + data.getNetworkBufferSize();
+            } },
+        event);
+};
+
+std::size_t standbyEventNetworkSize(const StandbyEvent &event) {
+    return std::visit(
+        utils::overloaded{
+            [](const StandbyStatusUpdate &) -> std::size_t {
+                return 1 + StandbyStatusUpdate::size;
+            },
+            [](const HotStandbyFeedbackMessage &) -> std::size_t {
+                return 1 + HotStandbyFeedbackMessage::size;
+            } },
+        event);
+};
+
+namespace {
+std::expected<std::span<char>, ParseError> writeCopyDataHeader(
+    const std::span<char> &buffer, std::size_t payloadSize) {
+    const auto &size = CopyDataFramer::headerSize + payloadSize;
+    if (buffer.size() < size) {
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::BUFFER_TOO_SMALL,
+            .eventType = static_cast<char>(CopyMessageType::CopyData),
+            .expectedSize = static_cast<std::uint32_t>(size),
+            .receivedSize = static_cast<std::uint32_t>(buffer.size()) });
+    };
+    buffer[0] = static_cast<char>(CopyMessageType::CopyData);
+    utils::int32ToNetwork(buffer.subspan<1, 4>(),
+                          sizeof(std::int32_t) + payloadSize);
+    return buffer.subspan(CopyDataFramer::headerSize, payloadSize);
+};
+};  // namespace
+
+std::expected<std::size_t, ParseError> primaryEventToCopyData(
+    const PrimaryEvent &event, const std::span<char> &buffer) {
+    const auto &payloadSize = primaryEventNetworkSize(event);
+    return writeCopyDataHeader(buffer, payloadSize)
+        .transform([&event, &payloadSize](const auto &payload) {
+            std::visit(
+                utils::overloaded{
+                    [&payload](const PrimaryKeepaliveMessage &message) {
+                        payload[0] = static_cast<char>(
+                            PrimaryEventType::PrimaryKeepaliveMessage);
+                        message.toNetworkBuffer(
+                            payload.template subspan<
+                                1, PrimaryKeepaliveMessage::size>());
+                    },
+                    [&payload](const XLogData &data) {
+                        payload[0] =
+                            static_cast<char>(PrimaryEventType::XLogData);
+                        data.toNetworkBuffer(payload.subspan(1));
+                    } },
+                event);
+            return CopyDataFramer::headerSize + payloadSize;
+        });
+};
+
+std::expected<std::size_t, ParseError> standbyEventToCopyData(
+    const StandbyEvent &event, const std::span<char> &buffer) {
+    const auto &payloadSize = standbyEventNetworkSize(event);
+    return writeCopyDataHeader(buffer, payloadSize)
+        .transform([&event, &payloadSize](const auto &payload) {
+            std::visit(
+                utils::overloaded{
+                    [&payload](const StandbyStatusUpdate &message) {
+                        payload[0] = static_cast<char>(
+                            StandbyEventType::StandbyStatusUpdate);
+                        message.toNetworkBuffer(
+                            payload.template subspan<
+                                1, StandbyStatusUpdate::size>());
+                    },
+                    [&payload](const HotStandbyFeedbackMessage &message) {
+                        payload[0] = static_cast<char>(
+                            StandbyEventType::HotStandbyFeedbackMessage);
+                        message.toNetworkBuffer(
+                            payload.template subspan<
+                                1, HotStandbyFeedbackMessage::size>());
+                    } },
+                event);
+            return CopyDataFramer::headerSize + payloadSize;
+        });
+};
+};  // namespace PGREPLICATION_NAMESPACE
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "./error.hpp"
+#include "./events.hpp"
+
+namespace PGREPLICATION_NAMESPACE {
+enum class CopyMessageType { CopyData = 'd', CopyDone = 'c' };
+
+struct CopyFrame {
+    char type;
+    std::span<char> payload;
+};
+
+// Reads the CopyData/CopyDone message at the start of buffer. Returns
+// std::nullopt while the message is incomplete; the frame occupies
+// headerSize + payload.size() bytes of buffer. Messages larger than
+// maxFrameSize are rejected.
+std::expected<std::optional<CopyFrame>, ParseError> frameCopyData(
+    const std::span<char> &buffer, std::size_t maxFrameSize);
+
+// Splits a raw COPY BOTH byte stream ('d' + int32 length + payload) into
+// frames without copying payloads. Bytes are received into a fixed buffer
+// through writable()/commit() or feed(); an incomplete trailing message is
+// moved to the front of the buffer when space is needed, so the buffer is
+// never reallocated and capacity bounds the largest accepted message.
+// Frames and events returned by next()/nextFrame() point into the buffer and
+// stay valid until the following writable() or feed() call.
+class CopyDataFramer {
+   public:
+    constexpr static std::size_t headerSize = 1 + sizeof(std::int32_t);
+    constexpr static std::size_t defaultCapacity = 1024 * 1024;
+
+    explicit CopyDataFramer(std::size_t capacity = defaultCapacity);
+
+    std::span<char> writable();
+    void commit(std::size_t size);
+    std::size_t feed(std::span<const char> chunk);
+
+    std::expected<std::optional<CopyFrame>, ParseError> nextFrame();
+    std::expected<std::optional<PrimaryEvent>, ParseError> next();
+
+    std::size_t buffered() const { return end - begin; };
+    std::size_t capacity() const { return bufferCapacity; };
+    void reset();
+
+   private:
+    void compact();
+
+    std::unique_ptr<char[]> buffer;
+    std::size_t bufferCapacity;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+std::size_t primaryEventNetworkSize(const PrimaryEvent &event);
+std::size_t standbyEventNetworkSize(const StandbyEvent &event);
+
+// Encode an event wrapped in a CopyData message into buffer and return the
+// number of bytes written.
+std::expected<std::size_t, ParseError> primaryEventToCopyData(
+    const PrimaryEvent &event, const std::span<char> &buffer);
+std::expected<std::size_t, ParseError> standbyEventToCopyData(
+    const StandbyEvent &event, const std::span<char> &buffer);
+};  // namespace PGREPLICATION_NAMESPACE
@@ -0,0 +1,49 @@
+#include "./error.hpp"
+
+#include <format>
+#include <string>
+
+namespace PGREPLICATION_NAMESPACE {
+std::string ParseError::message() const {
+    const auto &type = eventType == '\0' ? std::string("event")
+                                         : std::format("'{}' event", eventType);
+    switch (code) {
+        case ParseErrorCode::UNEXPECTED_TYPE:
+            return std::format("Unexpected type: '{}'", eventType);
+        case ParseErrorCode::NO_EVENT_TYPE_MATCHED:
+            return std::format("No event type was matched for {}", type);
+        case ParseErrorCode::BUFFER_SIZE_MISMATCH:
+            return std::format(
+                "{} buffer size must be {}, received: {} (offset {})", type,
+                expectedSize, receivedSize, offset);
+        case ParseErrorCode::BUFFER_TOO_SMALL:
+            return std::format(
+                "{} buffer size must be gte {}, received: {} (offset {})",
+                type, expectedSize, receivedSize, offset);
+        case ParseErrorCode::INVALID_LENGTH:
+            return std::format("Invalid message length: {} (offset {})",
+                               receivedSize, offset);
+        case ParseErrorCode::MESSAGE_TOO_LARGE:
+            return std::format("Message size {} exceeds capacity {}",
+                               receivedSize, expectedSize);
+        case ParseErrorCode::EMPTY_MESSAGE:
+            return std::format("Empty {} (offset {})", type, offset);
+        case ParseErrorCode::UNEXPECTED_EVENT:
+            return std::format("Unexpected {} in transaction stream", type);
+        case ParseErrorCode::INVALID_VALUE:
+            return std::format("Invalid column value (offset {})", offset);
+        case ParseErrorCode::COLUMN_COUNT_MISMATCH:
+            return std::format("{} has {} columns, expected {}", type,
+                               receivedSize, expectedSize);
+        case ParseErrorCode::UNTERMINATED_STRING:
+            return std::format("Unterminated string in {} (offset {})", type,
+                               offset);
+        case ParseErrorCode::MISSING_OLD_TUPLE:
+            return std::format("{} carries no old key or row", type);
+        case ParseErrorCode::TRUNCATED_STREAM:
+            return std::format("Stream ended inside a message, {} bytes left",
+                               receivedSize);
+    };
+    return std::format("Unknown parse error (offset {})", offset);
+};
+};  // namespace PGREPLICATION_NAMESPACE
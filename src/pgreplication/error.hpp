@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <string>
+
+namespace PGREPLICATION_NAMESPACE {
+enum class ParseErrorCode : std::uint8_t {
+    UNEXPECTED_TYPE,
+    NO_EVENT_TYPE_MATCHED,
+    BUFFER_SIZE_MISMATCH,
+    BUFFER_TOO_SMALL,
+    INVALID_LENGTH,
+    MESSAGE_TOO_LARGE,
+    EMPTY_MESSAGE,
+    UNEXPECTED_EVENT,
+    INVALID_VALUE,
+    COLUMN_COUNT_MISMATCH,
+    UNTERMINATED_STRING,
+    MISSING_OLD_TUPLE,
+    TRUNCATED_STREAM,
+};
+
+// Errors are plain values so that failing on malformed traffic does not
+// allocate; message() renders the human readable text on demand. offset is
+// the position in the message at which validation failed and eventType the
+// message type byte, or '\0' when it is not known.
+struct ParseError {
+    ParseErrorCode code;
+    char eventType = '\0';
+    std::uint32_t offset = 0;
+    std::uint32_t expectedSize = 0;
+    std::uint32_t receivedSize = 0;
+
+    std::string message() const;
+};
+};  // namespace PGREPLICATION_NAMESPACE
+
+namespace std {
+template <>
+struct formatter<PGREPLICATION_NAMESPACE::ParseError> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const PGREPLICATION_NAMESPACE::ParseError &record,
+                FormatContext &ctx) const {
+        return format_to(ctx.out(), "{}", record.message());
+    }
+};
+};  // namespace std
@@ -3,25 +3,29 @@
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <expected>
-#include <format>
 #include <optional>
 #include <ranges>
 #include <span>
-#include <string>
 #include <variant>
 #include <vector>
 
+#include "./error.hpp"
 #include "./utils.hpp"
 
 namespace PGREPLICATION_NAMESPACE {
-std::expected<XLogData, std::string> XLogData::fromNetworkBuffer(
+std::expected<XLogData, ParseError> XLogData::fromNetworkBuffer(
     const std::span<char> &buffer) {
     if (buffer.size() <= minSize) {
         return std::unexpected(
-            std::format("Size must be greater than {}, received: {}", minSize,
-                        buffer.size()));
+            ParseError{ .code = ParseErrorCode::BUFFER_TOO_SMALL,
+                        .eventType =
+                            static_cast<char>(PrimaryEventType::XLogData),
+                        .expectedSize = minSize + 1,
+                        .receivedSize =
+                            static_cast<std::uint32_t>(buffer.size()) });
     };
     return (XLogData){
         .messageWalStart = utils::int64FromNetwork(buffer.subspan<0, 8>()),
@@ -114,32 +118,46 @@ std::optional<PrimaryEventType> primaryEventTypeFromChar(const char &c) {
     };
 };
 
-std::expected<PrimaryEvent, std::string> primaryEventFromNetworkBuffer(
+std::expected<PrimaryEvent, ParseError> primaryEventFromNetworkBuffer(
     const std::span<char> &buffer) {
     assert(buffer.size() > 0);
     const auto &typeChar = buffer[0];
     const auto &typeResult = primaryEventTypeFromChar(typeChar);
     if (!typeResult.has_value()) {
-        return std::unexpected(std::format("Unexpected type: {}", typeChar));
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::UNEXPECTED_TYPE, .eventType = typeChar });
     };
     const auto &type = typeResult.value();
     const auto &eventBuffer = buffer.subspan(1);
     switch (type) {
         case PrimaryEventType::PrimaryKeepaliveMessage: {
             if (eventBuffer.size() != PrimaryKeepaliveMessage::size) {
-                return std::unexpected(std::format(
-                    "PrimaryKeepaliveMessage buffer size must be equal {}",
-                    PrimaryKeepaliveMessage::size));
+                return std::unexpected(ParseError{
+                    .code = ParseErrorCode::BUFFER_SIZE_MISMATCH,
+                    .eventType = typeChar,
+                    .offset = 1,
+                    .expectedSize = PrimaryKeepaliveMessage::size,
+                    .receivedSize =
+                        static_cast<std::uint32_t>(eventBuffer.size()) });
             };
             return PrimaryKeepaliveMessage::fromNetworkBuffer(
                 eventBuffer.subspan<0, PrimaryKeepaliveMessage::size>());
         }
         case PrimaryEventType::XLogData: {
             if (eventBuffer.size() < XLogData::minSize) {
-                return std::unexpected(std::format(
-                    "XLogData buffer size must be gte {}", XLogData::minSize));
+                return std::unexpected(ParseError{
+                    .code = ParseErrorCode::BUFFER_TOO_SMALL,
+                    .eventType = typeChar,
+                    .offset = 1,
+                    .expectedSize = XLogData::minSize,
+                    .receivedSize =
+                        static_cast<std::uint32_t>(eventBuffer.size()) });
             };
-            return XLogData::fromNetworkBuffer(eventBuffer);
+            return XLogData::fromNetworkBuffer(eventBuffer)
+                .transform_error([](ParseError error) {
+                    error.offset += 1;
+                    return error;
+                });
         }
     };
 };
@@ -185,31 +203,40 @@ std::optional<StandbyEventType> standbyEventTypeFromChar(const char &c) {
     };
 };
 
-std::expected<StandbyEvent, std::string> standbyEventFromNetworkBuffer(
+std::expected<StandbyEvent, ParseError> standbyEventFromNetworkBuffer(
     const std::span<char> &buffer) {
     assert(buffer.size() > 0);
     const auto &typeChar = buffer[0];
     const auto &typeResult = standbyEventTypeFromChar(typeChar);
     if (!typeResult.has_value()) {
-        return std::unexpected(std::format("Unexpected type: {}", typeChar));
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::UNEXPECTED_TYPE, .eventType = typeChar });
     };
     const auto &type = typeResult.value();
     const auto &eventBuffer = buffer.subspan(1);
     switch (type) {
         case StandbyEventType::StandbyStatusUpdate: {
             if (eventBuffer.size() != StandbyStatusUpdate::size) {
-                return std::unexpected(std::format(
-                    "StandbyStatusUpdate buffer size must be equal {}",
-                    StandbyStatusUpdate::size));
+                return std::unexpected(ParseError{
+                    .code = ParseErrorCode::BUFFER_SIZE_MISMATCH,
+                    .eventType = typeChar,
+                    .offset = 1,
+                    .expectedSize = StandbyStatusUpdate::size,
+                    .receivedSize =
+                        static_cast<std::uint32_t>(eventBuffer.size()) });
             };
             return StandbyStatusUpdate::fromNetworkBuffer(
                 eventBuffer.subspan<0, StandbyStatusUpdate::size>());
         }
         case StandbyEventType::HotStandbyFeedbackMessage: {
             if (eventBuffer.size() != HotStandbyFeedbackMessage::size) {
-                return std::unexpected(std::format(
-                    "HotStandbyFeedbackMessage buffer size must be equal {}",
-                    HotStandbyFeedbackMessage::size));
+                return std::unexpected(ParseError{
+                    .code = ParseErrorCode::BUFFER_SIZE_MISMATCH,
+                    .eventType = typeChar,
+                    .offset = 1,
+                    .expectedSize = HotStandbyFeedbackMessage::size,
+                    .receivedSize =
+                        static_cast<std::uint32_t>(eventBuffer.size()) });
             };
             return HotStandbyFeedbackMessage::fromNetworkBuffer(
                 std::span<char, HotStandbyFeedbackMessage::size>(eventBuffer));
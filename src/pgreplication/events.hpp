@@ -12,6 +12,8 @@
 #include <variant>
 #include <vector>
 
+#include "./error.hpp"
+
 namespace PGREPLICATION_NAMESPACE {
 
 enum class PrimaryEventType { XLogData = 'w', PrimaryKeepaliveMessage = 'k' };
@@ -33,7 +35,7 @@ struct XLogData {
     std::size_t getNetworkBufferSize() const;
     void toNetworkBuffer(const network_buffer &buffer) const;
 
-    static std::expected<XLogData, std::string> fromNetworkBuffer(
+    static std::expected<XLogData, ParseError> fromNetworkBuffer(
         const network_buffer &buffer);
 };
 
@@ -89,7 +91,7 @@ using PrimaryEvent = std::variant<XLogData, PrimaryKeepaliveMessage>;
 using StandbyEvent =
     std::variant<StandbyStatusUpdate, HotStandbyFeedbackMessage>;
 
-std::expected<PrimaryEvent, std::string> primaryEventFromNetworkBuffer(
+std::expected<PrimaryEvent, ParseError> primaryEventFromNetworkBuffer(
     const std::span<char> &buffer);
 
 std::optional<PrimaryEventType> primaryEventTypeFromChar(const char &c);
@@ -103,7 +105,7 @@ std::vector<char> primaryEventToNetworkBuffer(const PrimaryEvent &event);
 
 std::optional<StandbyEventType> standbyEventTypeFromChar(const char &c);
 
-std::expected<StandbyEvent, std::string> standbyEventFromNetworkBuffer(
+std::expected<StandbyEvent, ParseError> standbyEventFromNetworkBuffer(
     const std::span<char> &buffer);
 
 std::array<char, 1 + StandbyStatusUpdate::size>
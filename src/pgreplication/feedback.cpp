@@ -0,0 +1,100 @@
+#include "./feedback.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <variant>
+
+#include "./events.hpp"
+#include "./utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE {
+namespace {
+constexpr std::chrono::seconds postgresEpochOffset{ 946684800 };
+
+void advance(std::atomic<std::int64_t> &watermark, std::int64_t lsn) {
+    auto current = watermark.load(std::memory_order_relaxed);
+    while (current < lsn &&
+           !watermark.compare_exchange_weak(current, lsn,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+    };
+};
+};  // namespace
+
+std::int64_t postgresTimestamp(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               time.time_since_epoch() - postgresEpochOffset)
+        .count();
+};
+
+FeedbackController::FeedbackController(std::chrono::milliseconds interval,
+                                       std::chrono::milliseconds minInterval,
+                                       bool advanceOnIdle)
+    : interval(interval),
+      minInterval(minInterval),
+      advanceOnIdle(advanceOnIdle),
+      lastSent(clock::now()) {};
+
+void FeedbackController::advanceWritten(std::int64_t lsn) {
+    advance(writtenLsn, lsn);
+};
+
+// Anything flushed has been written and anything applied has been flushed
+// from the server's point of view, so the lower watermarks follow.
+void FeedbackController::advanceFlushed(std::int64_t lsn) {
+    advance(writtenLsn, lsn);
+    advance(flushedLsn, lsn);
+};
+
+void FeedbackController::advanceApplied(std::int64_t lsn) {
+    advanceFlushed(lsn);
+    advance(appliedLsn, lsn);
+};
+
+void FeedbackController::observe(const PrimaryEvent &event) {
+    std::visit(
+        utils::overloaded{
+            [this](const XLogData &data) {
+                advanceWritten(data.messageWalStart);
+            },
+            [this](const PrimaryKeepaliveMessage &message) {
+                if (advanceOnIdle) {
+                    const auto currentWritten = written();
+                    if (applied() >= currentWritten &&
+                        message.serverWalEnd > currentWritten) {
+                        advanceApplied(message.serverWalEnd);
+                    };
+                };
+                if (message.replyRequested) requestReply();
+            } },
+        event);
+};
+
+StandbyStatusUpdate FeedbackController::status() const {
+    return { .writtenWalPosition = written(),
+             .flushedWalPosition = flushed(),
+             .appliedWalPosition = applied(),
+             .sentAtUnixTimestamp =
+                 postgresTimestamp(std::chrono::system_clock::now()),
+             .replyRequested = false };
+};
+
+std::optional<FeedbackController::frame> FeedbackController::poll(
+    clock::time_point now) {
+    const auto &current = status();
+    const auto moved =
+        current.writtenWalPosition != lastStatus.writtenWalPosition ||
+        current.flushedWalPosition != lastStatus.flushedWalPosition ||
+        current.appliedWalPosition != lastStatus.appliedWalPosition;
+    const auto reply = replyPending.exchange(false);
+    if (!reply && now < lastSent + interval &&
+        (!moved || now < lastSent + minInterval)) {
+        return std::nullopt;
+    };
+    lastSent = now;
+    lastStatus = current;
+    return standByStatusUpdateToNetworkBuffer(current);
+};
+};  // namespace PGREPLICATION_NAMESPACE
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "./events.hpp"
+
+namespace PGREPLICATION_NAMESPACE {
+// Microseconds since 2000-01-01 00:00:00 UTC, the epoch used by the
+// replication protocol timestamps.
+std::int64_t postgresTimestamp(std::chrono::system_clock::time_point time);
+
+// Decides when to send StandbyStatusUpdate and what it reports. The
+// written, flushed and applied watermarks only move forward and can be
+// advanced from any thread; observe() and poll() belong to the thread that
+// owns the connection. Advances are coalesced: poll() returns a frame when
+// the server asked for a reply, when a watermark moved and at least
+// minInterval passed since the previous frame, or when interval passed
+// regardless so the server does not time the consumer out.
+//
+// With advanceOnIdle, a keepalive received while everything written has
+// also been flushed and applied moves all three watermarks to its
+// serverWalEnd. Without that an idle slot, e.g. one whose database sees no
+// writes while others do, never advances and the primary retains WAL.
+class FeedbackController {
+   public:
+    using clock = std::chrono::steady_clock;
+    using frame = std::array<char, 1 + StandbyStatusUpdate::size>;
+
+    constexpr static std::chrono::milliseconds defaultInterval{ 10000 };
+    constexpr static std::chrono::milliseconds defaultMinInterval{ 100 };
+
+    explicit FeedbackController(
+        std::chrono::milliseconds interval = defaultInterval,
+        std::chrono::milliseconds minInterval = defaultMinInterval,
+        bool advanceOnIdle = true);
+
+    void advanceWritten(std::int64_t lsn);
+    void advanceFlushed(std::int64_t lsn);
+    void advanceApplied(std::int64_t lsn);
+
+    std::int64_t written() const {
+        return writtenLsn.load(std::memory_order_acquire);
+    };
+    std::int64_t flushed() const {
+        return flushedLsn.load(std::memory_order_acquire);
+    };
+    std::int64_t applied() const {
+        return appliedLsn.load(std::memory_order_acquire);
+    };
+
+    void observe(const PrimaryEvent &event);
+    void requestReply() { replyPending.store(true); };
+
+    std::optional<frame> poll(clock::time_point now = clock::now());
+    StandbyStatusUpdate status() const;
+    // The latest time poll() has to be called by for the interval to hold.
+    clock::time_point deadline() const { return lastSent + interval; };
+
+   private:
+    std::chrono::milliseconds interval;
+    std::chrono::milliseconds minInterval;
+    bool advanceOnIdle;
+    std::atomic<std::int64_t> writtenLsn = 0;
+    std::atomic<std::int64_t> flushedLsn = 0;
+    std::atomic<std::int64_t> appliedLsn = 0;
+    std::atomic<bool> replyPending = false;
+    clock::time_point lastSent;
+    StandbyStatusUpdate lastStatus{};
+};
+};  // namespace PGREPLICATION_NAMESPACE
@@ -0,0 +1,342 @@
+#include "./io_uring_reader.hpp"
+
+#ifdef PGREPLICATION_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "./copy_data.hpp"
+#include "./error.hpp"
+#include "./events.hpp"
+#include "./utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE {
+namespace {
+constexpr unsigned queueDepth = 8;
+constexpr std::uint16_t bufferGroup = 0;
+constexpr std::uint64_t receiveTag = 1;
+constexpr std::size_t maxBlockCount = 32768;
+
+std::error_code lastError() {
+    return std::error_code(errno, std::system_category());
+};
+
+void *mapRing(int ringFd, std::size_t size, std::uint64_t offset) {
+    auto *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ringFd, offset);
+    return memory == MAP_FAILED ? nullptr : memory;
+};
+
+template <typename T>
+T *ringField(void *ring, std::uint32_t offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+};
+};  // namespace
+
+IoUringReader::IoUringReader(int fd, bool socket, std::size_t blockSize,
+                             std::size_t blockCount,
+                             std::size_t maxMessageSize)
+    : fd(fd),
+      socket(socket),
+      blockSize(std::clamp<std::size_t>(blockSize, CopyDataFramer::headerSize,
+                                        UINT32_MAX)),
+      blockCount(std::bit_ceil(std::clamp<std::size_t>(blockCount, 1,
+                                                        maxBlockCount))),
+      maxMessageSize(maxMessageSize) {};
+
+std::expected<std::unique_ptr<IoUringReader>, std::error_code>
+IoUringReader::create(int fd, std::size_t blockSize, std::size_t blockCount,
+                      std::size_t maxMessageSize) {
+    struct stat status;
+    if (fstat(fd, &status) != 0) return std::unexpected(lastError());
+    auto reader = std::unique_ptr<IoUringReader>(
+        new IoUringReader(fd, S_ISSOCK(status.st_mode), blockSize,
+                          blockCount, maxMessageSize));
+    if (const auto &error = reader->setup()) return std::unexpected(error);
+    return reader;
+};
+
+std::error_code IoUringReader::setup() {
+    io_uring_params params = {};
+    // Every block may complete before the next reap, plus the completion
+    // ending the receive; a smaller queue would overflow and end the
+    // multishot receive early.
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = static_cast<std::uint32_t>(
+        std::max<std::size_t>(blockCount * 2, queueDepth * 2));
+    ringFd =
+        static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+    if (ringFd < 0) return lastError();
+
+    submissionRingSize =
+        params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    completionRingSize =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const auto singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        submissionRingSize = std::max(submissionRingSize, completionRingSize);
+        completionRingSize = 0;
+    };
+    submissionRing =
+        mapRing(ringFd, submissionRingSize, IORING_OFF_SQ_RING);
+    if (submissionRing == nullptr) return lastError();
+    if (singleMap) {
+        completionRing = submissionRing;
+    } else {
+        completionRing =
+            mapRing(ringFd, completionRingSize, IORING_OFF_CQ_RING);
+        if (completionRing == nullptr) return lastError();
+    };
+    submissionsSize = params.sq_entries * sizeof(io_uring_sqe);
+    submissions = static_cast<io_uring_sqe *>(
+        mapRing(ringFd, submissionsSize, IORING_OFF_SQES));
+    if (submissions == nullptr) return lastError();
+
+    submissionTail = ringField<unsigned>(submissionRing, params.sq_off.tail);
+    submissionMask =
+        ringField<unsigned>(submissionRing, params.sq_off.ring_mask);
+    submissionArray = ringField<unsigned>(submissionRing, params.sq_off.array);
+    completionHead = ringField<unsigned>(completionRing, params.cq_off.head);
+    completionTail = ringField<unsigned>(completionRing, params.cq_off.tail);
+    completionMask =
+        ringField<unsigned>(completionRing, params.cq_off.ring_mask);
+    completions = ringField<io_uring_cqe>(completionRing, params.cq_off.cqes);
+
+    bufferRingSize = blockCount * sizeof(io_uring_buf);
+    auto *bufferMemory = mmap(nullptr, bufferRingSize, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (bufferMemory == MAP_FAILED) return lastError();
+    bufferRing = static_cast<io_uring_buf_ring *>(bufferMemory);
+    io_uring_buf_reg registration = {};
+    registration.ring_addr = reinterpret_cast<std::uint64_t>(bufferRing);
+    registration.ring_entries = static_cast<std::uint32_t>(blockCount);
+    registration.bgid = bufferGroup;
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PBUF_RING,
+                &registration, 1) < 0) {
+        return lastError();
+    };
+
+    blocks = std::make_unique_for_overwrite<char[]>(blockCount * blockSize);
+    for (std::size_t id = 0; id < blockCount; id++) {
+        provide(static_cast<std::uint16_t>(id));
+    };
+    publishBuffers();
+    return {};
+};
+
+IoUringReader::~IoUringReader() {
+    if (bufferRing != nullptr) munmap(bufferRing, bufferRingSize);
+    if (submissions != nullptr) munmap(submissions, submissionsSize);
+    if (completionRing != nullptr && completionRing != submissionRing) {
+        munmap(completionRing, completionRingSize);
+    };
+    if (submissionRing != nullptr) munmap(submissionRing, submissionRingSize);
+    if (ringFd >= 0) close(ringFd);
+};
+
+void IoUringReader::provide(std::uint16_t id) {
+    // Not bufferRing->bufs: in C++ the empty struct the kernel header puts
+    // in front of the flexible array takes a byte and shifts it.
+    auto &buffer = reinterpret_cast<io_uring_buf *>(
+        bufferRing)[bufferTail & (blockCount - 1)];
+    buffer.addr =
+        reinterpret_cast<std::uint64_t>(blocks.get() + id * blockSize);
+    buffer.len = static_cast<std::uint32_t>(blockSize);
+    buffer.bid = id;
+    bufferTail++;
+};
+
+void IoUringReader::publishBuffers() {
+    std::atomic_ref(bufferRing->tail)
+        .store(bufferTail, std::memory_order_release);
+};
+
+void IoUringReader::arm() {
+    const auto tail = *submissionTail;
+    const auto index = tail & *submissionMask;
+    auto &submission = submissions[index];
+    std::memset(&submission, 0, sizeof(submission));
+    if (socket) {
+        submission.opcode = IORING_OP_RECV;
+        submission.ioprio = IORING_RECV_MULTISHOT;
+    } else {
+        // Offset -1 reads from and advances the file position.
+        submission.opcode = IORING_OP_READ;
+        submission.off = static_cast<std::uint64_t>(-1);
+        submission.len = static_cast<std::uint32_t>(blockSize);
+    };
+    submission.fd = fd;
+    submission.flags = IOSQE_BUFFER_SELECT;
+    submission.buf_group = bufferGroup;
+    submission.user_data = receiveTag;
+    submissionArray[index] = index;
+    std::atomic_ref(*submissionTail).store(tail + 1, std::memory_order_release);
+    pendingSubmissions++;
+    armed = true;
+};
+
+void IoUringReader::reap() {
+    auto head = *completionHead;
+    const auto tail =
+        std::atomic_ref(*completionTail).load(std::memory_order_acquire);
+    for (; head != tail; head++) {
+        const auto &completion = completions[head & *completionMask];
+        if (completion.user_data != receiveTag) continue;
+        if ((completion.flags & IORING_CQE_F_MORE) == 0) armed = false;
+        if (completion.res > 0) {
+            chunks.push_back(Chunk{
+                .id = static_cast<std::uint16_t>(completion.flags >>
+                                                 IORING_CQE_BUFFER_SHIFT),
+                .offset = 0,
+                .size = static_cast<std::uint32_t>(completion.res) });
+            continue;
+        };
+        if ((completion.flags & IORING_CQE_F_BUFFER) != 0) {
+            provide(static_cast<std::uint16_t>(completion.flags >>
+                                               IORING_CQE_BUFFER_SHIFT));
+            publishBuffers();
+        };
+        // ENOBUFS: every block holds unread data, rearmed by waitForData()
+        // once next() consumed some of them.
+        if (completion.res == -ENOBUFS) continue;
+        if (completion.res < 0) {
+            ioError = std::error_code(-completion.res, std::system_category());
+        };
+        ended = true;
+    };
+    std::atomic_ref(*completionHead).store(head, std::memory_order_release);
+};
+
+void IoUringReader::waitForData() {
+    if (!armed) arm();
+    while (syscall(__NR_io_uring_enter, ringFd, pendingSubmissions, 1,
+                   IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+        if (errno == EINTR) continue;
+        ioError = lastError();
+        ended = true;
+        return;
+    };
+    pendingSubmissions = 0;
+    reap();
+};
+
+std::span<char> IoUringReader::chunkData(const Chunk &chunk) {
+    return std::span<char>(blocks.get() + chunk.id * blockSize + chunk.offset,
+                           chunk.size - chunk.offset);
+};
+
+std::expected<std::optional<CopyFrame>, ParseError>
+IoUringReader::nextFrame() {
+    if (!assembling) {
+        if (chunks.empty()) return std::nullopt;
+        auto &chunk = chunks.front();
+        const auto &frame = frameCopyData(chunkData(chunk), maxMessageSize);
+        if (!frame.has_value()) return frame;
+        if (frame.value().has_value()) {
+            chunk.offset += CopyDataFramer::headerSize +
+                            frame.value().value().payload.size();
+            if (chunk.offset == chunk.size) {
+                released.push_back(chunk.id);
+                chunks.pop_front();
+            };
+            return frame;
+        };
+        assembling = true;
+        spill.clear();
+    };
+    // The message crosses the end of a block: gather it in spill and hand
+    // the blocks back right away, so a message larger than the free blocks
+    // cannot stall the stream.
+    while (true) {
+        const auto &frame = frameCopyData(spill, maxMessageSize);
+        if (!frame.has_value()) return frame;
+        if (frame.value().has_value()) {
+            assembling = false;
+            return frame;
+        };
+        if (chunks.empty()) return std::nullopt;
+        auto needed = CopyDataFramer::headerSize;
+        if (spill.size() >= CopyDataFramer::headerSize) {
+            needed = 1 + static_cast<std::size_t>(utils::int32FromNetwork(
+                             std::span(spill).subspan<1, 4>()));
+        };
+        auto &chunk = chunks.front();
+        const auto &data = chunkData(chunk);
+        const auto size = std::min(needed - spill.size(), data.size());
+        spill.insert(spill.end(), data.begin(), data.begin() + size);
+        chunk.offset += size;
+        if (chunk.offset == chunk.size) {
+            provide(chunk.id);
+            publishBuffers();
+            chunks.pop_front();
+        };
+    };
+};
+
+std::expected<std::optional<PrimaryEvent>, ParseError> IoUringReader::next() {
+    if (copyDone) return std::nullopt;
+    if (!released.empty()) {
+        for (const auto &id : released) provide(id);
+        publishBuffers();
+        released.clear();
+    };
+    while (true) {
+        const auto &frame = nextFrame();
+        if (!frame.has_value()) return std::unexpected(frame.error());
+        if (frame.value().has_value()) {
+            const auto &[type, payload] = frame.value().value();
+            if (type == static_cast<char>(CopyMessageType::CopyDone)) {
+                copyDone = true;
+                ended = true;
+                return std::nullopt;
+            };
+            if (type != static_cast<char>(CopyMessageType::CopyData)) {
+                return std::unexpected(ParseError{
+                    .code = ParseErrorCode::UNEXPECTED_TYPE,
+                    .eventType = type });
+            };
+            if (payload.empty()) {
+                return std::unexpected(ParseError{
+                    .code = ParseErrorCode::EMPTY_MESSAGE,
+                    .eventType = type,
+                    .offset = CopyDataFramer::headerSize });
+            };
+            return primaryEventFromNetworkBuffer(payload)
+                .transform([](auto &&event) {
+                    return std::optional<PrimaryEvent>(std::move(event));
+                })
+                .transform_error([](ParseError error) {
+                    error.offset += CopyDataFramer::headerSize;
+                    return error;
+                });
+        };
+        if (ended && assembling) {
+            return std::unexpected(ParseError{
+                .code = ParseErrorCode::TRUNCATED_STREAM,
+                .receivedSize = static_cast<std::uint32_t>(spill.size()) });
+        };
+        if (ended) return std::nullopt;
+        reap();
+        if (chunks.empty() && !ended) waitForData();
+    };
+};
+};  // namespace PGREPLICATION_NAMESPACE
+
+#endif
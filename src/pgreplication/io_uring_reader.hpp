@@ -0,0 +1,125 @@
+#pragma once
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && \
+    !defined(PGREPLICATION_DISABLE_IO_URING)
+#define PGREPLICATION_IO_URING 1
+#endif
+
+#ifdef PGREPLICATION_IO_URING
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include "./copy_data.hpp"
+#include "./error.hpp"
+#include "./events.hpp"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+namespace PGREPLICATION_NAMESPACE {
+// Receives a COPY BOTH stream through io_uring. A pool of fixed blocks is
+// registered with the kernel as a provided buffer ring, and a socket is
+// read with a single multishot receive that keeps filling blocks without a
+// submission per read; other descriptors (e.g. a file holding a recorded
+// stream) are read one block at a time. Completions are reaped from the
+// shared ring, so the only system calls are the waits for more data.
+//
+// next() works like CopyDataFramer::next(): XLogData::walData points into
+// the block the message arrived in and stays valid until the following
+// next(). Only messages crossing the end of a block are copied, into a
+// spill buffer. Blocks are handed back to the kernel once consumed; while
+// all of them hold unread data the kernel stops receiving, which bounds
+// memory to blockCount * blockSize plus the largest message.
+//
+// The stream ends with CopyDone, the end of the input or an I/O error,
+// after which next() returns std::nullopt and error() tells them apart.
+// Input ending inside a message fails next() with TRUNCATED_STREAM.
+// The descriptor stays owned by the caller. Requires Linux 6.0 or newer;
+// define PGREPLICATION_DISABLE_IO_URING to leave the reader out.
+class IoUringReader {
+   public:
+    constexpr static std::size_t defaultBlockSize = 64 * 1024;
+    constexpr static std::size_t defaultBlockCount = 64;
+
+    // blockCount is rounded up to a power of two, at most 32768.
+    static std::expected<std::unique_ptr<IoUringReader>, std::error_code>
+    create(int fd, std::size_t blockSize = defaultBlockSize,
+           std::size_t blockCount = defaultBlockCount,
+           std::size_t maxMessageSize = CopyDataFramer::defaultCapacity);
+
+    ~IoUringReader();
+
+    IoUringReader(const IoUringReader &) = delete;
+    IoUringReader &operator=(const IoUringReader &) = delete;
+
+    std::expected<std::optional<PrimaryEvent>, ParseError> next();
+
+    std::error_code error() const { return ioError; };
+
+   private:
+    struct Chunk {
+        std::uint16_t id;
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    IoUringReader(int fd, bool socket, std::size_t blockSize,
+                  std::size_t blockCount, std::size_t maxMessageSize);
+
+    std::error_code setup();
+    void provide(std::uint16_t id);
+    void publishBuffers();
+    void arm();
+    void reap();
+    void waitForData();
+    std::span<char> chunkData(const Chunk &chunk);
+    std::expected<std::optional<CopyFrame>, ParseError> nextFrame();
+
+    int fd;
+    bool socket;
+    std::size_t blockSize;
+    std::size_t blockCount;
+    std::size_t maxMessageSize;
+
+    int ringFd = -1;
+    void *submissionRing = nullptr;
+    std::size_t submissionRingSize = 0;
+    void *completionRing = nullptr;
+    std::size_t completionRingSize = 0;
+    io_uring_sqe *submissions = nullptr;
+    std::size_t submissionsSize = 0;
+    unsigned *submissionTail = nullptr;
+    unsigned *submissionMask = nullptr;
+    unsigned *submissionArray = nullptr;
+    unsigned *completionHead = nullptr;
+    unsigned *completionTail = nullptr;
+    unsigned *completionMask = nullptr;
+    io_uring_cqe *completions = nullptr;
+    unsigned pendingSubmissions = 0;
+
+    io_uring_buf_ring *bufferRing = nullptr;
+    std::size_t bufferRingSize = 0;
+    std::uint16_t bufferTail = 0;
+    std::unique_ptr<char[]> blocks;
+
+    std::deque<Chunk> chunks;
+    std::vector<std::uint16_t> released;
+    std::vector<char> spill;
+    bool assembling = false;
+    bool armed = false;
+    bool ended = false;
+    bool copyDone = false;
+    std::error_code ioError;
+};
+};  // namespace PGREPLICATION_NAMESPACE
+
+#endif
@@ -0,0 +1,81 @@
+#include "./local_wal_sender.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <span>
+
+#include "./copy_data.hpp"
+#include "./events.hpp"
+#include "./utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE {
+LocalWalSender::LocalWalSender(std::size_t chunkSize)
+    : chunkSize(std::max<std::size_t>(chunkSize, 1)) {};
+
+void LocalWalSender::append(const PrimaryEvent &event) {
+    const auto &offset = stream.size();
+    const auto &size =
+        CopyDataFramer::headerSize + primaryEventNetworkSize(event);
+    stream.resize(offset + size);
+    primaryEventToCopyData(event, std::span(stream).subspan(offset));
+};
+
+void LocalWalSender::send(const std::span<char> &message,
+                          std::int64_t walStart) {
+    {
+        std::lock_guard lock(mutex);
+        walEnd = std::max(walEnd, walStart + static_cast<std::int64_t>(
+                                                 message.size()));
+        append(XLogData{ .messageWalStart = walStart,
+                         .serverWalEnd = walEnd,
+                         .sentAtUnixTimestamp = 0,
+                         .walData = message });
+    };
+    available.notify_all();
+};
+
+void LocalWalSender::sendKeepalive(std::int64_t serverWalEnd,
+                                   bool replyRequested) {
+    {
+        std::lock_guard lock(mutex);
+        walEnd = std::max(walEnd, serverWalEnd);
+        append(PrimaryKeepaliveMessage{ .serverWalEnd = walEnd,
+                                        .sentAtUnixTimestamp = 0,
+                                        .replyRequested = replyRequested });
+    };
+    available.notify_all();
+};
+
+void LocalWalSender::finish() {
+    {
+        std::lock_guard lock(mutex);
+        const auto &offset = stream.size();
+        stream.resize(offset + CopyDataFramer::headerSize);
+        stream[offset] = static_cast<char>(CopyMessageType::CopyDone);
+        utils::int32ToNetwork(
+            std::span(stream).subspan(offset + 1).first<sizeof(std::int32_t)>(),
+            sizeof(std::int32_t));
+        finished = true;
+    };
+    available.notify_all();
+};
+
+std::size_t LocalWalSender::read(const std::span<char> &buffer) {
+    std::unique_lock lock(mutex);
+    available.wait(lock, [this] {
+        return readOffset < stream.size() || finished;
+    });
+    const auto size = std::min({ buffer.size(), chunkSize,
+                                 stream.size() - readOffset });
+    std::memcpy(buffer.data(), stream.data() + readOffset, size);
+    readOffset += size;
+    if (readOffset == stream.size()) {
+        stream.clear();
+        readOffset = 0;
+    };
+    return size;
+};
+};  // namespace PGREPLICATION_NAMESPACE
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "./events.hpp"
+
+namespace PGREPLICATION_NAMESPACE {
+// In-process stand-in for a walsender. Messages are encoded the way a
+// START_REPLICATION connection delivers them (XLogData or keepalives
+// wrapped in CopyData, ended by CopyDone) and handed out by read() in
+// chunks of at most chunkSize bytes, so frame and pipeline code can be
+// exercised without a server, including messages split across reads.
+// send*() and read() may be called from different threads.
+class LocalWalSender {
+   public:
+    constexpr static std::size_t defaultChunkSize = 16 * 1024;
+
+    explicit LocalWalSender(std::size_t chunkSize = defaultChunkSize);
+
+    // Queues a pgoutput message as XLogData starting at walStart.
+    void send(const std::span<char> &message, std::int64_t walStart);
+    void sendKeepalive(std::int64_t serverWalEnd, bool replyRequested);
+    // Queues CopyDone; read() returns 0 once everything was read.
+    void finish();
+
+    // Blocks until bytes are available, then copies up to chunkSize of them
+    // into buffer, like recv() on the replication connection.
+    std::size_t read(const std::span<char> &buffer);
+
+   private:
+    // Called with mutex held.
+    void append(const PrimaryEvent &event);
+
+    std::mutex mutex;
+    std::condition_variable available;
+    std::vector<char> stream;
+    std::size_t readOffset = 0;
+    std::size_t chunkSize;
+    std::int64_t walEnd = 0;
+    bool finished = false;
+};
+};  // namespace PGREPLICATION_NAMESPACE
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <variant>
+
+#include "./options.hpp"
+#include "pgreplication/error.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Parses events into a monotonic arena that is released at the end of every
+// transaction or stream segment: after Commit, and in streaming and
+// two-phase sessions after StreamStop, StreamCommit, StreamAbort, Prepare
+// and StreamPrepare, so a workload that is streamed end to end does not
+// grow the arena either. Events returned by parseEvent stay valid until the
+// first parseEvent call after such an event (or an explicit release());
+// copy or materialize() anything that has to outlive it, e.g. streamed
+// chunks held until StreamCommit.
+//
+// Only tuple data is allocated from the arena, and sessions opt in through
+// their TupleStorage: ARENA for owned columns, or BORROWED, LAZY and PACKED,
+// whose containers take the arena too. OWNED tuples are plain std
+// containers and always use the heap.
+template <typename Context>
+class TransactionArena {
+   public:
+    static_assert(Context::TupleStorage != TupleStorageValue::OWNED,
+                  "OWNED tuple data is heap allocated, use "
+                  "TupleStorageValue::ARENA");
+
+    constexpr static std::size_t defaultInitialSize = 64 * 1024;
+
+    explicit TransactionArena(std::size_t initialSize = defaultInitialSize)
+        : initialBuffer(
+              std::make_unique_for_overwrite<std::byte[]>(initialSize)),
+          memoryResource(initialBuffer.get(), initialSize) {};
+
+    TransactionArena(const TransactionArena &) = delete;
+    TransactionArena &operator=(const TransactionArena &) = delete;
+
+    std::expected<typename Context::Event, ParseError> parseEvent(
+        const std::span<char> &buffer) {
+        if (releasePending) release();
+        auto result = Context::parseEvent(buffer, &memoryResource);
+        if (result.has_value() && endsSegment(result.value())) {
+            releasePending = true;
+        };
+        return result;
+    };
+
+    std::pmr::memory_resource *resource() { return &memoryResource; };
+
+    void release() {
+        memoryResource.release();
+        releasePending = false;
+    };
+
+   private:
+    static bool endsSegment(const typename Context::Event &event) {
+        using events = typename Context::events;
+        if (std::holds_alternative<typename events::Commit>(event)) {
+            return true;
+        };
+        if constexpr (Context::StreamingEnabled == StreamingEnabledValue::ON) {
+            if (std::holds_alternative<typename events::StreamStop>(event) ||
+                std::holds_alternative<typename events::StreamCommit>(event) ||
+                std::holds_alternative<typename events::StreamAbort>(event)) {
+                return true;
+            };
+        };
+        if constexpr (Context::TwoPhase == TwoPhaseValue::ON) {
+            if (std::holds_alternative<typename events::Prepare>(event)) {
+                return true;
+            };
+        };
+        if constexpr (Context::TwoPhase == TwoPhaseValue::ON &&
+                      Context::StreamingEnabled == StreamingEnabledValue::ON) {
+            if (std::holds_alternative<typename events::StreamPrepare>(
+                    event)) {
+                return true;
+            };
+        };
+        return false;
+    };
+
+    std::unique_ptr<std::byte[]> initialBuffer;
+    std::pmr::monotonic_buffer_resource memoryResource;
+    bool releasePending = false;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,227 @@
+#include "./arrow.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "./binary_decoders.hpp"
+#include "./columnar.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+namespace {
+// Everything an exported schema points to. The root and every child hold a
+// reference so they can be released in any order.
+struct ExportedSchema {
+    struct Field {
+        std::string format;
+        std::string name;
+        std::string metadata;
+    };
+
+    std::vector<Field> fields;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema *> childPointers;
+};
+
+struct ExportedArray {
+    ColumnarBatch batch;
+    std::vector<std::array<const void *, 3>> buffers;
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray *> childPointers;
+};
+
+// Non-null stand-in for empty buffers, which some consumers dereference.
+alignas(64) constexpr std::byte emptyBuffer[8] = {};
+
+const char *arrowFormat(const ColumnBuffer &column) {
+    switch (column.layout) {
+        case ColumnLayout::BOOLEAN:
+            return "b";
+        case ColumnLayout::INT16:
+            return "s";
+        case ColumnLayout::INT32:
+            return "i";
+        case ColumnLayout::INT64:
+            return "l";
+        case ColumnLayout::FLOAT32:
+            return "f";
+        case ColumnLayout::FLOAT64:
+            return "g";
+        case ColumnLayout::DATE32:
+            return "tdD";
+        case ColumnLayout::TIMESTAMP_MICROS:
+            return static_cast<TypeOid>(column.oid) == TypeOid::TIMESTAMPTZ
+                       ? "tsu:UTC"
+                       : "tsu:";
+        case ColumnLayout::FIXED_SIZE_BINARY:
+            return "w:16";
+        case ColumnLayout::UTF8:
+            return "u";
+        case ColumnLayout::BINARY:
+            return "z";
+    };
+    return "z";
+};
+
+void appendInt32(std::string &buffer, std::int32_t value) {
+    char bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    buffer.append(bytes, sizeof(bytes));
+};
+
+// Metadata is a native endian int32 pair count followed by length prefixed
+// keys and values.
+std::string typeOidMetadata(std::int32_t oid) {
+    constexpr std::string_view key = "pgreplication.type_oid";
+    char value[16];
+    const auto &[end, error] = std::to_chars(
+        value, value + sizeof(value), static_cast<std::uint32_t>(oid));
+    std::string metadata;
+    appendInt32(metadata, 1);
+    appendInt32(metadata, static_cast<std::int32_t>(key.size()));
+    metadata.append(key);
+    appendInt32(metadata, static_cast<std::int32_t>(end - value));
+    metadata.append(value, end);
+    return metadata;
+};
+
+template <typename Exported>
+Exported &owner(void *privateData) {
+    return **static_cast<std::shared_ptr<Exported> *>(privateData);
+};
+
+template <typename Exported, typename Arrow>
+void releaseExported(Arrow *arrow) {
+    if (arrow->release == nullptr) return;
+    for (std::int64_t index = 0; index < arrow->n_children; index++) {
+        auto *child = arrow->children[index];
+        if (child->release != nullptr) child->release(child);
+    };
+    delete static_cast<std::shared_ptr<Exported> *>(arrow->private_data);
+    arrow->release = nullptr;
+};
+
+void releaseSchema(ArrowSchema *schema) {
+    releaseExported<ExportedSchema>(schema);
+};
+
+void releaseArray(ArrowArray *array) {
+    releaseExported<ExportedArray>(array);
+};
+};  // namespace
+
+void exportArrowSchema(const ColumnarBatch &batch, ArrowSchema *out) {
+    auto exported = std::make_shared<ExportedSchema>();
+    exported->fields.push_back({ .format = "C",
+                                 .name = "_operation",
+                                 .metadata = {} });
+    for (const auto &column : batch.columns) {
+        exported->fields.push_back(
+            { .format = arrowFormat(column),
+              .name = column.name,
+              .metadata = typeOidMetadata(column.oid) });
+    };
+    exported->fields.push_back(
+        { .format = "+s", .name = batch.relationName, .metadata = {} });
+
+    const auto &childCount = exported->fields.size() - 1;
+    exported->children.resize(childCount);
+    exported->childPointers.resize(childCount);
+    for (std::size_t index = 0; index < childCount; index++) {
+        const auto &field = exported->fields[index];
+        exported->children[index] = ArrowSchema{
+            .format = field.format.c_str(),
+            .name = field.name.c_str(),
+            .metadata = field.metadata.empty() ? nullptr
+                                               : field.metadata.data(),
+            .flags = index == 0 ? 0 : ARROW_FLAG_NULLABLE,
+            .n_children = 0,
+            .children = nullptr,
+            .dictionary = nullptr,
+            .release = releaseSchema,
+            .private_data = new std::shared_ptr<ExportedSchema>(exported),
+        };
+        exported->childPointers[index] = &exported->children[index];
+    };
+    const auto &root = exported->fields.back();
+    *out = ArrowSchema{
+        .format = root.format.c_str(),
+        .name = root.name.c_str(),
+        .metadata = nullptr,
+        .flags = 0,
+        .n_children = static_cast<std::int64_t>(childCount),
+        .children = exported->childPointers.data(),
+        .dictionary = nullptr,
+        .release = releaseSchema,
+        .private_data = new std::shared_ptr<ExportedSchema>(exported),
+    };
+};
+
+void exportArrowArray(ColumnarBatch &&batch, ArrowArray *out) {
+    auto exported = std::make_shared<ExportedArray>();
+    exported->batch = std::move(batch);
+    const auto &source = exported->batch;
+    const auto &length = static_cast<std::int64_t>(source.size);
+    const auto &childCount = source.columns.size() + 1;
+    const auto &orEmpty = [](const auto &buffer) -> const void * {
+        return buffer.empty() ? static_cast<const void *>(emptyBuffer)
+                              : static_cast<const void *>(buffer.data());
+    };
+
+    exported->buffers.resize(childCount);
+    exported->children.resize(childCount);
+    exported->childPointers.resize(childCount);
+    exported->buffers[0] = { nullptr, orEmpty(source.operations), nullptr };
+    exported->children[0] = ArrowArray{ .length = length,
+                                        .null_count = 0,
+                                        .n_buffers = 2 };
+    for (std::size_t index = 1; index < childCount; index++) {
+        const auto &column = source.columns[index - 1];
+        const auto &variableSize = column.layout == ColumnLayout::UTF8 ||
+                                   column.layout == ColumnLayout::BINARY;
+        exported->buffers[index] = {
+            column.nullCount == 0 ? nullptr : column.validity.data(),
+            orEmpty(column.values),
+            variableSize ? orEmpty(column.data) : nullptr,
+        };
+        exported->children[index] = ArrowArray{
+            .length = length,
+            .null_count = static_cast<std::int64_t>(column.nullCount),
+            .n_buffers = variableSize ? 3 : 2,
+        };
+    };
+    for (std::size_t index = 0; index < childCount; index++) {
+        auto &child = exported->children[index];
+        child.offset = 0;
+        child.n_children = 0;
+        child.buffers = exported->buffers[index].data();
+        child.children = nullptr;
+        child.dictionary = nullptr;
+        child.release = releaseArray;
+        child.private_data = new std::shared_ptr<ExportedArray>(exported);
+        exported->childPointers[index] = &child;
+    };
+
+    // A struct array needs only its (absent) validity buffer.
+    static const void *rootBuffers[1] = { nullptr };
+    *out = ArrowArray{
+        .length = length,
+        .null_count = 0,
+        .offset = 0,
+        .n_buffers = 1,
+        .n_children = static_cast<std::int64_t>(childCount),
+        .buffers = rootBuffers,
+        .children = exported->childPointers.data(),
+        .dictionary = nullptr,
+        .release = releaseArray,
+        .private_data = new std::shared_ptr<ExportedArray>(exported),
+    };
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+#include "./columnar.hpp"
+
+// Arrow C Data Interface, as specified in
+// https://arrow.apache.org/docs/format/CDataInterface.html. The guard is
+// the one mandated by the specification, so this header can be combined
+// with Arrow's own.
+extern "C" {
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+    void (*release)(struct ArrowSchema *);
+    void *private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+    void (*release)(struct ArrowArray *);
+    void *private_data;
+};
+
+#endif
+}
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Describes a batch as a struct with one child per relation column,
+// preceded by "_operation", a uint8 column holding the RowOperation
+// character of each row. Each field carries the PostgreSQL type oid in its
+// "pgreplication.type_oid" metadata entry. timestamptz columns are
+// exported with the UTC time zone, timestamp columns without one.
+void exportArrowSchema(const ColumnarBatch &batch, ArrowSchema *out);
+
+// Moves the batch into out without copying any buffer. The buffers are
+// freed by the release callback of out, or of a child that was moved out
+// of it, whichever runs last.
+void exportArrowArray(ColumnarBatch &&batch, ArrowArray *out);
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <format>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pgreplication/error.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+struct EventBatchError {
+    std::size_t index;
+    ParseError error;
+};
+
+// Reusable output of SessionContext::parseEvents. clear() keeps the capacity
+// of events, so a consumer draining many messages per wakeup only allocates
+// while the batch grows to its steady-state size.
+template <typename Event>
+struct EventBatch {
+    std::vector<Event> events;
+    std::optional<EventBatchError> error;
+
+    EventBatch() = default;
+    explicit EventBatch(std::size_t capacity) { events.reserve(capacity); };
+
+    std::size_t size() const { return events.size(); };
+    bool ok() const { return !error.has_value(); };
+
+    void clear() {
+        events.clear();
+        error.reset();
+    };
+};
+
+// The loop behind every parseEvents: appends what parse returns for each
+// message to out and returns how many events were added, stopping at the
+// first error. parse returns std::expected of either an Event or an
+// std::optional<Event>, where std::nullopt leaves the message out.
+template <typename Event, typename Parse>
+std::size_t parseBatch(const std::span<const std::span<char>> &messages,
+                       EventBatch<Event> &out, Parse &&parse) {
+    const auto &initialSize = out.events.size();
+    out.events.reserve(initialSize + messages.size());
+    for (std::size_t index = 0; index < messages.size(); index++) {
+        auto result = parse(messages[index]);
+        if (!result.has_value()) {
+            out.error =
+                EventBatchError{ .index = index, .error = result.error() };
+            break;
+        };
+        if constexpr (std::is_same_v<typename decltype(result)::value_type,
+                                     Event>) {
+            out.events.emplace_back(std::move(result.value()));
+        } else if (result.value().has_value()) {
+            out.events.emplace_back(std::move(result.value().value()));
+        };
+    };
+    return out.events.size() - initialSize;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
+
+namespace std {
+template <>
+struct formatter<PGREPLICATION_NAMESPACE::pgoutput::EventBatchError> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(
+        const PGREPLICATION_NAMESPACE::pgoutput::EventBatchError &record,
+        FormatContext &ctx) const {
+        return format_to(ctx.out(), "EventBatchError(index: {}, error: {})",
+                         record.index, record.error);
+    }
+};
+};  // namespace std
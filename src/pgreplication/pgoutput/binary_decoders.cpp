@@ -0,0 +1,286 @@
+#include "./binary_decoders.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "pgreplication/error.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+bool isArrayTypeOid(std::int32_t oid) {
+    switch (static_cast<TypeOid>(oid)) {
+        case TypeOid::BOOL_ARRAY:
+        case TypeOid::BYTEA_ARRAY:
+        case TypeOid::INT2_ARRAY:
+        case TypeOid::INT4_ARRAY:
+        case TypeOid::TEXT_ARRAY:
+        case TypeOid::BPCHAR_ARRAY:
+        case TypeOid::VARCHAR_ARRAY:
+        case TypeOid::INT8_ARRAY:
+        case TypeOid::FLOAT4_ARRAY:
+        case TypeOid::FLOAT8_ARRAY:
+        case TypeOid::OID_ARRAY:
+        case TypeOid::TIMESTAMP_ARRAY:
+        case TypeOid::DATE_ARRAY:
+        case TypeOid::TIMESTAMPTZ_ARRAY:
+        case TypeOid::NUMERIC_ARRAY:
+        case TypeOid::UUID_ARRAY:
+        case TypeOid::JSONB_ARRAY:
+            return true;
+        default:
+            return false;
+    };
+};
+
+std::int16_t Numeric::digit(std::size_t index) const {
+    return fromNetwork<std::int16_t>(digitBytes.data() + index * 2);
+};
+
+double Numeric::toDouble() const {
+    switch (sign) {
+        case Sign::NOT_A_NUMBER:
+            return std::numeric_limits<double>::quiet_NaN();
+        case Sign::POSITIVE_INFINITY:
+            return std::numeric_limits<double>::infinity();
+        case Sign::NEGATIVE_INFINITY:
+            return -std::numeric_limits<double>::infinity();
+        default:
+            break;
+    };
+    double value = 0;
+    for (std::size_t index = 0; index < digitCount(); index++) {
+        value = value * 10000 + digit(index);
+    };
+    const auto &exponent = static_cast<int>(weight) + 1 -
+                           static_cast<int>(digitCount());
+    value *= std::pow(10000.0, exponent);
+    return sign == Sign::NEGATIVE ? -value : value;
+};
+
+namespace {
+void appendDigit(std::string &result, std::int16_t digit, bool pad) {
+    char text[4];
+    const auto &[end, error] = std::to_chars(text, text + 4, digit);
+    const auto &length = static_cast<std::size_t>(end - text);
+    if (pad) result.append(4 - length, '0');
+    result.append(text, length);
+};
+};  // namespace
+
+std::string Numeric::toString() const {
+    switch (sign) {
+        case Sign::NOT_A_NUMBER:
+            return "NaN";
+        case Sign::POSITIVE_INFINITY:
+            return "Infinity";
+        case Sign::NEGATIVE_INFINITY:
+            return "-Infinity";
+        default:
+            break;
+    };
+    const auto &digitAt = [this](int index) -> std::int16_t {
+        if (index < 0 || index >= static_cast<int>(digitCount())) return 0;
+        return digit(static_cast<std::size_t>(index));
+    };
+    std::string result;
+    if (sign == Sign::NEGATIVE) result.push_back('-');
+    if (weight < 0) {
+        result.push_back('0');
+    } else {
+        appendDigit(result, digitAt(0), false);
+        for (int index = 1; index <= weight; index++) {
+            appendDigit(result, digitAt(index), true);
+        };
+    };
+    if (displayScale > 0) {
+        result.push_back('.');
+        const auto &end = result.size() + displayScale;
+        for (int index = weight + 1; result.size() < end; index++) {
+            appendDigit(result, digitAt(index), true);
+        };
+        result.resize(end);
+    };
+    return result;
+};
+
+template <>
+std::expected<Numeric, ParseError> decodeBinary<Numeric>(
+    std::span<const std::byte> buffer) {
+    constexpr std::size_t headerSize = 4 * sizeof(std::int16_t);
+    if (buffer.size() < headerSize) {
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::BUFFER_TOO_SMALL,
+            .expectedSize = headerSize,
+            .receivedSize = static_cast<std::uint32_t>(buffer.size()) });
+    };
+    const auto &digitCount =
+        static_cast<std::size_t>(fromNetwork<std::uint16_t>(buffer.data()));
+    const auto &size = headerSize + digitCount * sizeof(std::int16_t);
+    if (buffer.size() != size) return binarySizeMismatch(size, buffer.size());
+    return Numeric{
+        .weight = fromNetwork<std::int16_t>(buffer.data() + 2),
+        .sign = static_cast<Numeric::Sign>(
+            fromNetwork<std::uint16_t>(buffer.data() + 4)),
+        .displayScale = fromNetwork<std::int16_t>(buffer.data() + 6),
+        .digitBytes = buffer.subspan(headerSize),
+    };
+};
+
+std::int32_t ArrayView::dimension(std::size_t index) const {
+    return fromNetwork<std::int32_t>(dimensions.data() + index * 8);
+};
+
+std::int32_t ArrayView::lowerBound(std::size_t index) const {
+    return fromNetwork<std::int32_t>(dimensions.data() + index * 8 + 4);
+};
+
+ArrayView::iterator::value_type ArrayView::iterator::operator*() const {
+    const auto &length = fromNetwork<std::int32_t>(remaining.data());
+    if (length < 0) return std::nullopt;
+    return remaining.subspan(sizeof(std::int32_t),
+                             static_cast<std::size_t>(length));
+};
+
+ArrayView::iterator &ArrayView::iterator::operator++() {
+    const auto &length = fromNetwork<std::int32_t>(remaining.data());
+    remaining = remaining.subspan(
+        sizeof(std::int32_t) +
+        (length < 0 ? 0 : static_cast<std::size_t>(length)));
+    index++;
+    return *this;
+};
+
+// Validates the whole layout once so iterating does not need to.
+std::expected<ArrayView, ParseError> ArrayView::fromBuffer(
+    std::span<const std::byte> buffer) {
+    constexpr std::size_t headerSize = 3 * sizeof(std::int32_t);
+    const auto &tooSmall = [&buffer](std::size_t offset, std::size_t size) {
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::BUFFER_TOO_SMALL,
+            .offset = static_cast<std::uint32_t>(offset),
+            .expectedSize = static_cast<std::uint32_t>(size),
+            .receivedSize = static_cast<std::uint32_t>(buffer.size()) });
+    };
+    if (buffer.size() < headerSize) return tooSmall(0, headerSize);
+    ArrayView view;
+    view.dimensionCount = fromNetwork<std::int32_t>(buffer.data());
+    view.hasNulls = fromNetwork<std::int32_t>(buffer.data() + 4) != 0;
+    view.elementOid = fromNetwork<std::int32_t>(buffer.data() + 8);
+    if (view.dimensionCount < 0) {
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::INVALID_LENGTH,
+            .receivedSize = static_cast<std::uint32_t>(view.dimensionCount) });
+    };
+    const auto &dimensionsSize =
+        static_cast<std::size_t>(view.dimensionCount) * 8;
+    if (buffer.size() < headerSize + dimensionsSize) {
+        return tooSmall(headerSize, headerSize + dimensionsSize);
+    };
+    view.dimensions = buffer.subspan(headerSize, dimensionsSize);
+    view.elements = buffer.subspan(headerSize + dimensionsSize);
+    view.elementCount = view.dimensionCount == 0 ? 0 : 1;
+    for (std::int32_t index = 0; index < view.dimensionCount; index++) {
+        view.elementCount *= static_cast<std::size_t>(
+            std::max(view.dimension(index), 0));
+    };
+
+    std::size_t offset = 0;
+    for (std::size_t index = 0; index < view.elementCount; index++) {
+        if (view.elements.size() < offset + sizeof(std::int32_t)) {
+            return tooSmall(headerSize + dimensionsSize + offset,
+                            headerSize + dimensionsSize + offset +
+                                sizeof(std::int32_t));
+        };
+        const auto &length =
+            fromNetwork<std::int32_t>(view.elements.data() + offset);
+        offset += sizeof(std::int32_t);
+        if (length > 0) offset += static_cast<std::size_t>(length);
+    };
+    if (view.elements.size() != offset) {
+        return binarySizeMismatch(headerSize + dimensionsSize + offset,
+                                  buffer.size());
+    };
+    return view;
+};
+
+namespace {
+template <typename T>
+std::expected<DecodedValue, ParseError> decodeAs(
+    std::span<const std::byte> buffer) {
+    return decodeBinary<T>(buffer).transform(
+        [](T value) { return DecodedValue(std::move(value)); });
+};
+};  // namespace
+
+std::expected<DecodedValue, ParseError> decodeBinary(
+    std::int32_t oid, std::span<const std::byte> buffer) {
+    if (isArrayTypeOid(oid)) return decodeAs<ArrayView>(buffer);
+    switch (static_cast<TypeOid>(oid)) {
+        case TypeOid::BOOL:
+            return decodeAs<bool>(buffer);
+        case TypeOid::INT2:
+            return decodeAs<std::int16_t>(buffer);
+        case TypeOid::INT4:
+        case TypeOid::OID:
+            return decodeAs<std::int32_t>(buffer);
+        case TypeOid::INT8:
+            return decodeAs<std::int64_t>(buffer);
+        case TypeOid::FLOAT4:
+            return decodeAs<float>(buffer);
+        case TypeOid::FLOAT8:
+            return decodeAs<double>(buffer);
+        case TypeOid::CHAR:
+        case TypeOid::NAME:
+        case TypeOid::TEXT:
+        case TypeOid::JSON:
+        case TypeOid::BPCHAR:
+        case TypeOid::VARCHAR:
+            return decodeAs<std::string_view>(buffer);
+        case TypeOid::JSONB:
+            // Binary jsonb is a version byte followed by the json text.
+            if (buffer.empty()) {
+                return std::unexpected(ParseError{
+                    .code = ParseErrorCode::BUFFER_TOO_SMALL,
+                    .expectedSize = 1 });
+            };
+            return decodeAs<std::string_view>(buffer.subspan(1));
+        case TypeOid::DATE:
+            return decodeAs<Date>(buffer);
+        case TypeOid::TIMESTAMP:
+        case TypeOid::TIMESTAMPTZ:
+            return decodeAs<Timestamp>(buffer);
+        case TypeOid::NUMERIC:
+            return decodeAs<Numeric>(buffer);
+        case TypeOid::UUID:
+            return decodeAs<Uuid>(buffer);
+        default:
+            return decodeAs<std::span<const std::byte>>(buffer);
+    };
+};
+
+std::expected<DecodedValue, ParseError> decodeBinaryColumn(
+    std::int32_t oid,
+    const events::TupleDataColumnView<BinaryValue::ON> &column) {
+    return std::visit(
+        [oid](const auto &value) -> std::expected<DecodedValue, ParseError> {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, std::span<const std::byte>>) {
+                return decodeBinary(oid, value);
+            } else {
+                return value;
+            };
+        },
+        column);
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
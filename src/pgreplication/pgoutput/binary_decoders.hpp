@@ -0,0 +1,350 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "./events/base/tuple_data.hpp"
+#include "./options.hpp"
+#include "pgreplication/error.hpp"
+#include "pgreplication/utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Oids of the built-in types (pg_type.dat) the binary decoders know about.
+enum class TypeOid : std::int32_t {
+    BOOL = 16,
+    BYTEA = 17,
+    CHAR = 18,
+    NAME = 19,
+    INT8 = 20,
+    INT2 = 21,
+    INT4 = 23,
+    TEXT = 25,
+    OID = 26,
+    JSON = 114,
+    FLOAT4 = 700,
+    FLOAT8 = 701,
+    BPCHAR = 1042,
+    VARCHAR = 1043,
+    DATE = 1082,
+    TIMESTAMP = 1114,
+    TIMESTAMPTZ = 1184,
+    NUMERIC = 1700,
+    UUID = 2950,
+    JSONB = 3802,
+
+    BOOL_ARRAY = 1000,
+    BYTEA_ARRAY = 1001,
+    INT2_ARRAY = 1005,
+    INT4_ARRAY = 1007,
+    TEXT_ARRAY = 1009,
+    BPCHAR_ARRAY = 1014,
+    VARCHAR_ARRAY = 1015,
+    INT8_ARRAY = 1016,
+    FLOAT4_ARRAY = 1021,
+    FLOAT8_ARRAY = 1022,
+    OID_ARRAY = 1028,
+    TIMESTAMP_ARRAY = 1115,
+    DATE_ARRAY = 1182,
+    TIMESTAMPTZ_ARRAY = 1185,
+    NUMERIC_ARRAY = 1231,
+    UUID_ARRAY = 2951,
+    JSONB_ARRAY = 3807,
+};
+
+bool isArrayTypeOid(std::int32_t oid);
+
+// Timestamps are sent as microseconds since 2000-01-01 and dates as days
+// since then; both are converted to the unix epoch.
+using Timestamp =
+    std::chrono::time_point<std::chrono::system_clock,
+                            std::chrono::microseconds>;
+using Date = std::chrono::sys_days;
+using Uuid = std::array<std::byte, 16>;
+
+// A numeric in its wire form: base 10000 digits, most significant first,
+// the first one weighted 10000^weight. The digits are not copied.
+struct Numeric {
+    enum class Sign : std::uint16_t {
+        POSITIVE = 0x0000,
+        NEGATIVE = 0x4000,
+        NOT_A_NUMBER = 0xC000,
+        POSITIVE_INFINITY = 0xD000,
+        NEGATIVE_INFINITY = 0xF000,
+    };
+
+    std::int16_t weight;
+    Sign sign;
+    std::int16_t displayScale;
+    std::span<const std::byte> digitBytes;
+
+    std::size_t digitCount() const { return digitBytes.size() / 2; };
+    std::int16_t digit(std::size_t index) const;
+
+    bool isNaN() const { return sign == Sign::NOT_A_NUMBER; };
+    bool isInfinity() const {
+        return sign == Sign::POSITIVE_INFINITY ||
+               sign == Sign::NEGATIVE_INFINITY;
+    };
+    double toDouble() const;
+    std::string toString() const;
+};
+
+// A one or more dimensional array. Iterating yields the elements in
+// storage (row-major) order as views, std::nullopt for NULL; decode them
+// with elementOid.
+class ArrayView {
+   public:
+    class iterator {
+       public:
+        using value_type = std::optional<std::span<const std::byte>>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(std::span<const std::byte> remaining, std::size_t index)
+            : remaining(remaining), index(index) {};
+
+        value_type operator*() const;
+        iterator &operator++();
+        iterator operator++(int) {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        };
+        bool operator==(const iterator &other) const {
+            return index == other.index;
+        };
+
+       private:
+        std::span<const std::byte> remaining;
+        std::size_t index = 0;
+    };
+
+    std::int32_t elementOid;
+    std::int32_t dimensionCount;
+    bool hasNulls;
+
+    std::int32_t dimension(std::size_t index) const;
+    std::int32_t lowerBound(std::size_t index) const;
+    std::size_t size() const { return elementCount; };
+
+    iterator begin() const { return { elements, 0 }; };
+    iterator end() const { return { {}, elementCount }; };
+
+    static std::expected<ArrayView, ParseError> fromBuffer(
+        std::span<const std::byte> buffer);
+
+   private:
+    std::span<const std::byte> dimensions;
+    std::span<const std::byte> elements;
+    std::size_t elementCount = 0;
+};
+
+using DecodedValue =
+    std::variant<events::PGNull, events::PGUnchangedToastedValue, bool,
+                 std::int16_t, std::int32_t, std::int64_t, float, double,
+                 std::string_view, std::span<const std::byte>, Uuid,
+                 Timestamp, Date, Numeric, ArrayView>;
+
+// Decoders for a single binary column payload. Fixed size values are read
+// straight from the buffer; variable size ones are returned as views into
+// it, so nothing is allocated and the result is only valid as long as the
+// buffer. Types without a decoder, and text-like types, come back as the
+// raw bytes or a string_view respectively.
+template <typename T>
+std::expected<T, ParseError> decodeBinary(std::span<const std::byte> buffer);
+
+// Reads a big-endian value of 2, 4 or 8 bytes through the wire helpers in
+// utils; the buffer may be unaligned.
+template <typename T>
+    requires std::is_arithmetic_v<T> && (sizeof(T) > 1)
+T fromNetwork(const std::byte *data) {
+    const auto *bytes = reinterpret_cast<const char *>(data);
+    if constexpr (sizeof(T) == 2) {
+        return std::bit_cast<T>(utils::int16FromNetwork(
+            utils::const_type_span<std::int16_t>(bytes, sizeof(T))));
+    } else if constexpr (sizeof(T) == 4) {
+        return std::bit_cast<T>(utils::int32FromNetwork(
+            utils::const_type_span<std::int32_t>(bytes, sizeof(T))));
+    } else {
+        return std::bit_cast<T>(utils::int64FromNetwork(
+            utils::const_type_span<std::int64_t>(bytes, sizeof(T))));
+    };
+};
+
+inline std::unexpected<ParseError> binarySizeMismatch(std::size_t expected,
+                                                      std::size_t received) {
+    return std::unexpected(
+        ParseError{ .code = ParseErrorCode::BUFFER_SIZE_MISMATCH,
+                    .expectedSize = static_cast<std::uint32_t>(expected),
+                    .receivedSize = static_cast<std::uint32_t>(received) });
+};
+
+template <typename T, std::size_t Size = sizeof(T)>
+std::expected<T, ParseError> decodeFixedBinary(
+    std::span<const std::byte> buffer) {
+    if (buffer.size() != Size) return binarySizeMismatch(Size, buffer.size());
+    return fromNetwork<T>(buffer.data());
+};
+
+template <>
+inline std::expected<bool, ParseError> decodeBinary<bool>(
+    std::span<const std::byte> buffer) {
+    if (buffer.size() != 1) return binarySizeMismatch(1, buffer.size());
+    return buffer[0] != std::byte{ 0 };
+};
+
+template <>
+inline std::expected<std::int16_t, ParseError> decodeBinary<std::int16_t>(
+    std::span<const std::byte> buffer) {
+    return decodeFixedBinary<std::int16_t>(buffer);
+};
+
+template <>
+inline std::expected<std::int32_t, ParseError> decodeBinary<std::int32_t>(
+    std::span<const std::byte> buffer) {
+    return decodeFixedBinary<std::int32_t>(buffer);
+};
+
+template <>
+inline std::expected<std::int64_t, ParseError> decodeBinary<std::int64_t>(
+    std::span<const std::byte> buffer) {
+    return decodeFixedBinary<std::int64_t>(buffer);
+};
+
+template <>
+inline std::expected<float, ParseError> decodeBinary<float>(
+    std::span<const std::byte> buffer) {
+    return decodeFixedBinary<float>(buffer);
+};
+
+template <>
+inline std::expected<double, ParseError> decodeBinary<double>(
+    std::span<const std::byte> buffer) {
+    return decodeFixedBinary<double>(buffer);
+};
+
+template <>
+inline std::expected<std::string_view, ParseError>
+decodeBinary<std::string_view>(std::span<const std::byte> buffer) {
+    return std::string_view(reinterpret_cast<const char *>(buffer.data()),
+                            buffer.size());
+};
+
+template <>
+inline std::expected<std::span<const std::byte>, ParseError>
+decodeBinary<std::span<const std::byte>>(std::span<const std::byte> buffer) {
+    return buffer;
+};
+
+template <>
+inline std::expected<Uuid, ParseError> decodeBinary<Uuid>(
+    std::span<const std::byte> buffer) {
+    Uuid value;
+    if (buffer.size() != value.size()) {
+        return binarySizeMismatch(value.size(), buffer.size());
+    };
+    std::memcpy(value.data(), buffer.data(), value.size());
+    return value;
+};
+
+template <>
+inline std::expected<Timestamp, ParseError> decodeBinary<Timestamp>(
+    std::span<const std::byte> buffer) {
+    return decodeFixedBinary<std::int64_t>(buffer).transform(
+        [](std::int64_t value) {
+            constexpr auto epoch =
+                std::chrono::sys_days(std::chrono::year(2000) / 1 / 1)
+                    .time_since_epoch();
+            constexpr auto offset =
+                std::chrono::duration_cast<std::chrono::microseconds>(epoch)
+                    .count();
+            // infinity and -infinity are sent as the int64 limits. The
+            // last years PostgreSQL accepts do not fit once shifted to the
+            // unix epoch, and saturate like infinity.
+            if (value > std::numeric_limits<std::int64_t>::max() - offset) {
+                return Timestamp::max();
+            };
+            if (value == std::numeric_limits<std::int64_t>::min()) {
+                return Timestamp::min();
+            };
+            return Timestamp(std::chrono::microseconds(value + offset));
+        });
+};
+
+template <>
+inline std::expected<Date, ParseError> decodeBinary<Date>(
+    std::span<const std::byte> buffer) {
+    return decodeFixedBinary<std::int32_t>(buffer).transform(
+        [](std::int32_t value) {
+            if (value == std::numeric_limits<std::int32_t>::max()) {
+                return Date::max();
+            };
+            if (value == std::numeric_limits<std::int32_t>::min()) {
+                return Date::min();
+            };
+            return Date(std::chrono::year(2000) / 1 / 1) +
+                   std::chrono::days(value);
+        });
+};
+
+template <>
+std::expected<Numeric, ParseError> decodeBinary<Numeric>(
+    std::span<const std::byte> buffer);
+
+template <>
+inline std::expected<ArrayView, ParseError> decodeBinary<ArrayView>(
+    std::span<const std::byte> buffer) {
+    return ArrayView::fromBuffer(buffer);
+};
+
+// Dispatches on the column type oid as announced in the Relation message
+// (RelationColumn::oid / CachedRelationColumn::oid).
+std::expected<DecodedValue, ParseError> decodeBinary(
+    std::int32_t oid, std::span<const std::byte> buffer);
+
+std::expected<DecodedValue, ParseError> decodeBinaryColumn(
+    std::int32_t oid,
+    const events::TupleDataColumnView<BinaryValue::ON> &column);
+
+inline std::expected<DecodedValue, ParseError> decodeBinaryColumn(
+    std::int32_t oid, const events::TupleDataColumn<BinaryValue::ON> &column) {
+    return decodeBinaryColumn(
+        oid, events::viewTupleColumn<BinaryValue::ON>(column));
+};
+
+inline std::expected<DecodedValue, ParseError> decodeBinaryColumn(
+    std::int32_t oid,
+    const events::ArenaTupleDataColumn<BinaryValue::ON> &column) {
+    return decodeBinaryColumn(
+        oid, events::viewTupleColumn<BinaryValue::ON>(column));
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
+
+namespace std {
+template <>
+struct formatter<PGREPLICATION_NAMESPACE::pgoutput::Numeric> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const PGREPLICATION_NAMESPACE::pgoutput::Numeric &record,
+                FormatContext &ctx) const {
+        return format_to(ctx.out(), "{}", record.toString());
+    }
+};
+};  // namespace std
@@ -0,0 +1,367 @@
+#include "./columnar.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "./binary_decoders.hpp"
+#include "./text_decoders.hpp"
+#include "pgreplication/error.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+namespace {
+std::uint32_t byteWidthFor(ColumnLayout layout) {
+    switch (layout) {
+        case ColumnLayout::INT16:
+            return 2;
+        case ColumnLayout::INT32:
+        case ColumnLayout::FLOAT32:
+        case ColumnLayout::DATE32:
+            return 4;
+        case ColumnLayout::INT64:
+        case ColumnLayout::FLOAT64:
+        case ColumnLayout::TIMESTAMP_MICROS:
+            return 8;
+        case ColumnLayout::FIXED_SIZE_BINARY:
+            return 16;
+        default:
+            return 0;
+    };
+};
+
+bool isVariableSize(ColumnLayout layout) {
+    return layout == ColumnLayout::UTF8 || layout == ColumnLayout::BINARY;
+};
+
+void appendBytes(ColumnBytes &buffer, const void *bytes, std::size_t size) {
+    const auto *begin = static_cast<const std::byte *>(bytes);
+    buffer.insert(buffer.end(), begin, begin + size);
+};
+
+template <typename T>
+void appendValue(ColumnBytes &buffer, T value) {
+    appendBytes(buffer, &value, sizeof(value));
+};
+
+void setBit(ColumnBytes &bitmap, std::size_t index, bool value) {
+    if (index % 8 == 0) bitmap.push_back(std::byte{ 0 });
+    if (value) bitmap[index / 8] |= std::byte{ 1 } << (index % 8);
+};
+
+void appendVariable(ColumnBuffer &column, const void *bytes,
+                    std::size_t size) {
+    appendBytes(column.data, bytes, size);
+    appendValue(column.values, static_cast<std::int32_t>(column.data.size()));
+};
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+};
+
+std::unexpected<ParseError> invalidValue() {
+    return std::unexpected(ParseError{ .code = ParseErrorCode::INVALID_VALUE });
+};
+
+// Converts a decoded value into the column's physical representation.
+template <typename Decode>
+std::expected<void, ParseError> appendDecoded(ColumnBuffer &column,
+                                              std::size_t row,
+                                              Decode &&decode) {
+    switch (column.layout) {
+        case ColumnLayout::BOOLEAN:
+            return decode.template operator()<bool>().transform(
+                [&column, row](bool value) {
+                    setBit(column.values, row, value);
+                });
+        case ColumnLayout::INT16:
+            return decode.template operator()<std::int16_t>().transform(
+                [&column](auto value) { appendValue(column.values, value); });
+        case ColumnLayout::INT32:
+            return decode.template operator()<std::int32_t>().transform(
+                [&column](auto value) { appendValue(column.values, value); });
+        case ColumnLayout::INT64:
+            return decode.template operator()<std::int64_t>().transform(
+                [&column](auto value) { appendValue(column.values, value); });
+        case ColumnLayout::FLOAT32:
+            return decode.template operator()<float>().transform(
+                [&column](auto value) { appendValue(column.values, value); });
+        case ColumnLayout::FLOAT64:
+            return decode.template operator()<double>().transform(
+                [&column](auto value) { appendValue(column.values, value); });
+        case ColumnLayout::DATE32:
+            return decode.template operator()<Date>().transform(
+                [&column](Date value) {
+                    // infinity and -infinity decode to Date::max() and
+                    // Date::min(), which DATE32 cannot hold.
+                    const auto days = std::clamp<std::int64_t>(
+                        value.time_since_epoch().count(),
+                        std::numeric_limits<std::int32_t>::min(),
+                        std::numeric_limits<std::int32_t>::max());
+                    appendValue(column.values, static_cast<std::int32_t>(days));
+                });
+        case ColumnLayout::TIMESTAMP_MICROS:
+            return decode.template operator()<Timestamp>().transform(
+                [&column](Timestamp value) {
+                    appendValue(column.values, static_cast<std::int64_t>(
+                                                   value.time_since_epoch()
+                                                       .count()));
+                });
+        case ColumnLayout::FIXED_SIZE_BINARY:
+            return decode.template operator()<Uuid>().transform(
+                [&column](const Uuid &value) {
+                    appendBytes(column.values, value.data(), value.size());
+                });
+        default:
+            return invalidValue();
+    };
+};
+};  // namespace
+
+ColumnLayout columnLayoutFor(std::int32_t oid, BinaryValue binary) {
+    switch (static_cast<TypeOid>(oid)) {
+        case TypeOid::BOOL:
+            return ColumnLayout::BOOLEAN;
+        case TypeOid::INT2:
+            return ColumnLayout::INT16;
+        case TypeOid::INT4:
+            return ColumnLayout::INT32;
+        // Oids are unsigned 32 bit, so they need the wider type.
+        case TypeOid::OID:
+        case TypeOid::INT8:
+            return ColumnLayout::INT64;
+        case TypeOid::FLOAT4:
+            return ColumnLayout::FLOAT32;
+        case TypeOid::FLOAT8:
+            return ColumnLayout::FLOAT64;
+        case TypeOid::DATE:
+            return ColumnLayout::DATE32;
+        case TypeOid::TIMESTAMP:
+        case TypeOid::TIMESTAMPTZ:
+            return ColumnLayout::TIMESTAMP_MICROS;
+        case TypeOid::UUID:
+            return ColumnLayout::FIXED_SIZE_BINARY;
+        case TypeOid::BYTEA:
+            return ColumnLayout::BINARY;
+        case TypeOid::CHAR:
+        case TypeOid::NAME:
+        case TypeOid::TEXT:
+        case TypeOid::JSON:
+        case TypeOid::JSONB:
+        case TypeOid::BPCHAR:
+        case TypeOid::VARCHAR:
+        case TypeOid::NUMERIC:
+            return ColumnLayout::UTF8;
+        default:
+            // Other types are kept in their wire format: text output is
+            // valid UTF-8, binary send output is opaque.
+            return binary == BinaryValue::ON ? ColumnLayout::BINARY
+                                             : ColumnLayout::UTF8;
+    };
+};
+
+ColumnarAccumulator::ColumnarAccumulator(const events::RelationSchema &schema,
+                                         BinaryValue binary,
+                                         std::size_t reserveRows)
+    : relationOid(schema.oid),
+      relationNamespace(schema.relationNamespace),
+      relationName(schema.name),
+      reservedRows(reserveRows) {
+    columns.reserve(schema.columns.size());
+    for (const auto &relationColumn : schema.columns) {
+        const auto &layout = columnLayoutFor(relationColumn.oid, binary);
+        columns.emplace_back(
+            ColumnBuffer{ .name = std::string(relationColumn.name),
+                          .oid = relationColumn.oid,
+                          .layout = layout,
+                          .byteWidth = byteWidthFor(layout) });
+    };
+    reserve(reserveRows);
+    clear();
+};
+
+void ColumnarAccumulator::reserve(std::size_t reserveRows) {
+    for (auto &column : columns) {
+        column.validity.reserve(reserveRows / 8 + 1);
+        if (isVariableSize(column.layout)) {
+            column.values.reserve((reserveRows + 1) * sizeof(std::int32_t));
+        } else if (column.layout == ColumnLayout::BOOLEAN) {
+            column.values.reserve(reserveRows / 8 + 1);
+        } else {
+            column.values.reserve(reserveRows * column.byteWidth);
+        };
+    };
+    rowOperations.reserve(reserveRows);
+};
+
+ColumnarBatch ColumnarAccumulator::take() {
+    ColumnarBatch batch = { .oid = relationOid,
+                            .relationNamespace = relationNamespace,
+                            .relationName = relationName,
+                            .size = rows,
+                            .columns = {},
+                            .operations = std::move(rowOperations) };
+    batch.columns.reserve(columns.size());
+    for (auto &column : columns) {
+        batch.columns.push_back(
+            ColumnBuffer{ .name = column.name,
+                          .oid = column.oid,
+                          .layout = column.layout,
+                          .byteWidth = column.byteWidth,
+                          .validity = std::move(column.validity),
+                          .values = std::move(column.values),
+                          .data = std::move(column.data),
+                          .nullCount = column.nullCount });
+        column.validity = {};
+        column.values = {};
+        column.data = {};
+    };
+    rowOperations = {};
+    reserve(reservedRows);
+    clear();
+    return batch;
+};
+
+void ColumnarAccumulator::clear() {
+    for (auto &column : columns) {
+        column.validity.clear();
+        column.values.clear();
+        column.data.clear();
+        column.nullCount = 0;
+        if (isVariableSize(column.layout)) {
+            appendValue(column.values, std::int32_t{ 0 });
+        };
+    };
+    rowOperations.clear();
+    rows = 0;
+};
+
+void ColumnarAccumulator::setValid(ColumnBuffer &column, bool valid) {
+    setBit(column.validity, rows, valid);
+    if (!valid) column.nullCount++;
+};
+
+void ColumnarAccumulator::appendNull(ColumnBuffer &column) {
+    setValid(column, false);
+    switch (column.layout) {
+        case ColumnLayout::BOOLEAN:
+            setBit(column.values, rows, false);
+            return;
+        case ColumnLayout::UTF8:
+        case ColumnLayout::BINARY:
+            appendValue(column.values,
+                        static_cast<std::int32_t>(column.data.size()));
+            return;
+        default:
+            column.values.resize(column.values.size() + column.byteWidth);
+            return;
+    };
+};
+
+std::expected<void, ParseError> ColumnarAccumulator::appendColumn(
+    ColumnBuffer &column,
+    const events::TupleDataColumnView<BinaryValue::OFF> &value) {
+    const auto *text = std::get_if<std::string_view>(&value);
+    if (text == nullptr) {
+        appendNull(column);
+        return {};
+    };
+    if (column.layout == ColumnLayout::UTF8) {
+        appendVariable(column, text->data(), text->size());
+    } else if (column.layout == ColumnLayout::BINARY) {
+        // bytea_output = hex; anything else is kept as sent.
+        if (!text->starts_with("\\x") || text->size() % 2 != 0) {
+            appendVariable(column, text->data(), text->size());
+        } else {
+            for (std::size_t index = 2; index < text->size(); index += 2) {
+                const auto &high = hexValue((*text)[index]);
+                const auto &low = hexValue((*text)[index + 1]);
+                if (high < 0 || low < 0) {
+                    column.data.resize(column.offsets().back());
+                    return invalidValue();
+                };
+                column.data.push_back(static_cast<std::byte>(high << 4 | low));
+            };
+            appendValue(column.values,
+                        static_cast<std::int32_t>(column.data.size()));
+        };
+    } else {
+        const auto &result =
+            appendDecoded(column, rows, [text]<typename T>() {
+                return decodeText<T>(*text);
+            });
+        if (!result.has_value()) return result;
+    };
+    setValid(column, true);
+    return {};
+};
+
+std::expected<void, ParseError> ColumnarAccumulator::appendColumn(
+    ColumnBuffer &column,
+    const events::TupleDataColumnView<BinaryValue::ON> &value) {
+    const auto *bytes = std::get_if<std::span<const std::byte>>(&value);
+    if (bytes == nullptr) {
+        appendNull(column);
+        return {};
+    };
+    const auto &oid = static_cast<TypeOid>(column.oid);
+    if (oid == TypeOid::NUMERIC) {
+        const auto &numeric = decodeBinary<Numeric>(*bytes);
+        if (!numeric.has_value()) return std::unexpected(numeric.error());
+        const auto &text = numeric.value().toString();
+        appendVariable(column, text.data(), text.size());
+    } else if (oid == TypeOid::JSONB && !bytes->empty()) {
+        appendVariable(column, bytes->data() + 1, bytes->size() - 1);
+    } else if (isVariableSize(column.layout)) {
+        appendVariable(column, bytes->data(), bytes->size());
+    } else if (oid == TypeOid::OID) {
+        const auto &result = decodeBinary<std::int32_t>(*bytes);
+        if (!result.has_value()) return std::unexpected(result.error());
+        appendValue(column.values, static_cast<std::int64_t>(
+                                       static_cast<std::uint32_t>(
+                                           result.value())));
+    } else {
+        const auto &result =
+            appendDecoded(column, rows, [bytes]<typename T>() {
+                return decodeBinary<T>(*bytes);
+            });
+        if (!result.has_value()) return result;
+    };
+    setValid(column, true);
+    return {};
+};
+
+// Drops the partial row left behind when a column failed to decode.
+void ColumnarAccumulator::rollback(std::size_t appendedColumns) {
+    const auto &byteCount = (rows + 7) / 8;
+    const auto &mask = static_cast<std::byte>((1u << (rows % 8)) - 1);
+    const auto &truncateBitmap = [byteCount, mask, this](ColumnBytes &bitmap) {
+        bitmap.resize(byteCount);
+        if (rows % 8 != 0) bitmap.back() &= mask;
+    };
+    for (std::size_t index = 0; index < appendedColumns; index++) {
+        auto &column = columns[index];
+        if (!column.isValid(rows)) column.nullCount--;
+        truncateBitmap(column.validity);
+        if (column.layout == ColumnLayout::BOOLEAN) {
+            truncateBitmap(column.values);
+        } else if (isVariableSize(column.layout)) {
+            column.values.resize((rows + 1) * sizeof(std::int32_t));
+            column.data.resize(column.offsets().back());
+        } else {
+            column.values.resize(rows * column.byteWidth);
+        };
+    };
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <new>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "./events/base/delete.hpp"
+#include "./events/base/insert.hpp"
+#include "./events/base/relation_cache.hpp"
+#include "./events/base/tuple_data.hpp"
+#include "./events/base/update.hpp"
+#include "./options.hpp"
+#include "pgreplication/error.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Allocates on 64 byte boundaries, the alignment columnar formats such as
+// Arrow recommend so buffers can be consumed with aligned SIMD loads.
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+    constexpr static std::align_val_t alignment{ 64 };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U> &) {};
+
+    T *allocate(std::size_t size) {
+        return static_cast<T *>(::operator new(size * sizeof(T), alignment));
+    };
+    void deallocate(T *pointer, std::size_t) {
+        ::operator delete(pointer, alignment);
+    };
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U> &) const {
+        return true;
+    };
+};
+
+using ColumnBytes = std::vector<std::byte, AlignedAllocator<std::byte>>;
+
+// Physical layout of a column. Fixed width layouts keep one value per row
+// in values; BOOLEAN packs them into a bitmap; UTF8 and BINARY keep rows + 1
+// int32 offsets in values and the concatenated bytes in data.
+enum class ColumnLayout : std::uint8_t {
+    BOOLEAN,
+    INT16,
+    INT32,
+    INT64,
+    FLOAT32,
+    FLOAT64,
+    // Days since the unix epoch.
+    DATE32,
+    // Microseconds since the unix epoch, UTC.
+    TIMESTAMP_MICROS,
+    FIXED_SIZE_BINARY,
+    UTF8,
+    BINARY,
+};
+
+enum class RowOperation : char { INSERT = 'I', UPDATE = 'U', DELETE = 'D' };
+
+struct ColumnBuffer {
+    std::string name;
+    std::int32_t oid;
+    ColumnLayout layout;
+    // Bytes per value for fixed width layouts, 0 otherwise.
+    std::uint32_t byteWidth;
+    // One bit per row, least significant bit first, set for non-null rows.
+    ColumnBytes validity;
+    ColumnBytes values;
+    ColumnBytes data;
+    std::size_t nullCount = 0;
+
+    bool isValid(std::size_t row) const {
+        return (std::to_integer<unsigned>(validity[row / 8]) >> (row % 8) &
+                1) != 0;
+    };
+
+    template <typename T>
+    std::span<const T> valuesAs() const {
+        return { reinterpret_cast<const T *>(values.data()),
+                 values.size() / sizeof(T) };
+    };
+    std::span<const std::int32_t> offsets() const {
+        return valuesAs<std::int32_t>();
+    };
+};
+
+ColumnLayout columnLayoutFor(std::int32_t oid, BinaryValue binary);
+
+// The rows accumulated so far, detached from the accumulator.
+struct ColumnarBatch {
+    std::int32_t oid;
+    std::string relationNamespace;
+    std::string relationName;
+    std::size_t size;
+    std::vector<ColumnBuffer> columns;
+    std::vector<RowOperation> operations;
+};
+
+// Accumulates the rows of Insert/Update/Delete events for one relation into
+// column-major buffers laid out like Arrow arrays (validity bitmaps,
+// fixed width values, int32 offsets + data), so a columnar writer can take
+// them as they are. Values are decoded from text or binary exactly once,
+// straight into their column. Updates append the new tuple and deletes the
+// old/key tuple, with the kind of change in operations(). Unchanged TOASTed
+// values are not sent by the server and are recorded as null.
+//
+// The schema is copied when the accumulator is created; start a new one
+// when a Relation message changes it. clear() keeps all capacity, take()
+// hands the buffers over without copying and starts new ones.
+class ColumnarAccumulator {
+   public:
+    explicit ColumnarAccumulator(const events::RelationSchema &schema,
+                                 BinaryValue binary,
+                                 std::size_t reserveRows = 1024);
+
+    template <BinaryValue Binary, StreamingEnabledValue Streaming,
+              TupleStorageValue Storage>
+    std::expected<void, ParseError> append(
+        const events::Insert<Binary, Streaming, Storage> &event) {
+        return appendRow<Binary>(RowOperation::INSERT, event.oid, event.data);
+    };
+
+    template <BinaryValue Binary, StreamingEnabledValue Streaming,
+              TupleStorageValue Storage>
+    std::expected<void, ParseError> append(
+        const events::Update<Binary, Streaming, Storage> &event) {
+        return appendRow<Binary>(RowOperation::UPDATE, event.oid, event.data);
+    };
+
+    template <BinaryValue Binary, StreamingEnabledValue Streaming,
+              TupleStorageValue Storage>
+    std::expected<void, ParseError> append(
+        const events::Delete<Binary, Streaming, Storage> &event) {
+        if (!event.oldDataOrPrimaryKey.has_value()) {
+            return std::unexpected(ParseError{
+                .code = ParseErrorCode::MISSING_OLD_TUPLE, .eventType = 'D' });
+        };
+        return std::visit(
+            [this, &event](const auto &tuple) {
+                return appendRow<Binary>(RowOperation::DELETE, event.oid,
+                                         tuple);
+            },
+            event.oldDataOrPrimaryKey.value());
+    };
+
+    std::int32_t oid() const { return relationOid; };
+    std::size_t size() const { return rows; };
+    std::span<const ColumnBuffer> columnBuffers() const { return columns; };
+    std::span<const RowOperation> operations() const {
+        return rowOperations;
+    };
+    void clear();
+    ColumnarBatch take();
+
+   private:
+    template <BinaryValue Binary, typename Tuple>
+    std::expected<void, ParseError> appendRow(RowOperation operation,
+                                              std::int32_t oid,
+                                              const Tuple &tuple) {
+        if (oid != relationOid) {
+            return std::unexpected(
+                ParseError{ .code = ParseErrorCode::UNEXPECTED_EVENT,
+                            .eventType = static_cast<char>(operation) });
+        };
+        if (tuple.size() != columns.size()) {
+            return std::unexpected(ParseError{
+                .code = ParseErrorCode::COLUMN_COUNT_MISMATCH,
+                .eventType = static_cast<char>(operation),
+                .expectedSize = static_cast<std::uint32_t>(columns.size()),
+                .receivedSize = static_cast<std::uint32_t>(tuple.size()) });
+        };
+        for (std::size_t index = 0; index < columns.size(); index++) {
+            const auto &column = [&tuple, index] {
+                using Column = std::decay_t<decltype(tuple[index])>;
+                using View = events::TupleDataColumnView<Binary>;
+                if constexpr (std::is_same_v<Column, View>) {
+                    return tuple[index];
+                } else {
+                    return events::viewTupleColumn<Binary>(tuple[index]);
+                };
+            }();
+            const auto &result = appendColumn(columns[index], column);
+            if (!result.has_value()) {
+                rollback(index);
+                auto error = result.error();
+                error.eventType = static_cast<char>(operation);
+                return std::unexpected(error);
+            };
+        };
+        rowOperations.push_back(operation);
+        rows++;
+        return {};
+    };
+
+    std::expected<void, ParseError> appendColumn(
+        ColumnBuffer &column,
+        const events::TupleDataColumnView<BinaryValue::OFF> &value);
+    std::expected<void, ParseError> appendColumn(
+        ColumnBuffer &column,
+        const events::TupleDataColumnView<BinaryValue::ON> &value);
+    void appendNull(ColumnBuffer &column);
+    void setValid(ColumnBuffer &column, bool valid);
+    void rollback(std::size_t appendedColumns);
+    void reserve(std::size_t reserveRows);
+
+    std::int32_t relationOid;
+    std::string relationNamespace;
+    std::string relationName;
+    std::size_t reservedRows;
+    std::vector<ColumnBuffer> columns;
+    std::vector<RowOperation> rowOperations;
+    std::size_t rows = 0;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
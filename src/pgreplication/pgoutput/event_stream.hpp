@@ -0,0 +1,185 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <variant>
+
+#include "pgreplication/copy_data.hpp"
+#include "pgreplication/error.hpp"
+#include "pgreplication/events.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Minimal asynchronous generator: co_await next() resumes the generator
+// until its next co_yield and returns a pointer to the yielded value, or
+// nullptr once it finished. Control moves between the generator and the
+// awaiting coroutine by symmetric transfer, so neither suspending nor
+// resuming allocates; whatever the generator co_awaits in between decides
+// where and when it continues. The yielded value stays valid until the
+// following next(). Exceptions escaping the generator are rethrown by
+// next(). The generator must not be destroyed while a next() is pending.
+template <typename T>
+class AsyncGenerator {
+   public:
+    struct promise_type;
+
+    struct TransferAwaiter {
+        bool await_ready() const noexcept { return false; };
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<promise_type> handle) noexcept {
+            return handle.promise().consumer;
+        };
+        void await_resume() const noexcept {};
+    };
+
+    struct promise_type {
+        T *current = nullptr;
+        std::coroutine_handle<> consumer;
+        std::exception_ptr exception;
+
+        AsyncGenerator get_return_object() {
+            return AsyncGenerator(
+                std::coroutine_handle<promise_type>::from_promise(*this));
+        };
+        std::suspend_always initial_suspend() const noexcept { return {}; };
+        TransferAwaiter final_suspend() noexcept {
+            current = nullptr;
+            return {};
+        };
+        TransferAwaiter yield_value(T &value) noexcept {
+            current = std::addressof(value);
+            return {};
+        };
+        TransferAwaiter yield_value(T &&value) noexcept {
+            current = std::addressof(value);
+            return {};
+        };
+        void return_void() const noexcept {};
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        };
+    };
+
+    struct NextAwaiter {
+        std::coroutine_handle<promise_type> handle;
+
+        bool await_ready() const noexcept { return handle.done(); };
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<> consumer) noexcept {
+            handle.promise().consumer = consumer;
+            return handle;
+        };
+        T *await_resume() const {
+            auto &promise = handle.promise();
+            if (promise.exception) {
+                std::rethrow_exception(std::exchange(promise.exception, {}));
+            };
+            return promise.current;
+        };
+    };
+
+    AsyncGenerator(AsyncGenerator &&other) noexcept
+        : handle(std::exchange(other.handle, {})) {};
+    AsyncGenerator &operator=(AsyncGenerator &&other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        };
+        return *this;
+    };
+    ~AsyncGenerator() {
+        if (handle) handle.destroy();
+    };
+
+    NextAwaiter next() { return { handle }; };
+
+   private:
+    explicit AsyncGenerator(std::coroutine_handle<promise_type> handle)
+        : handle(handle) {};
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+struct IgnoreKeepalives {
+    void operator()(const PrimaryKeepaliveMessage &) const {};
+};
+
+// Yields the events of a replication connection. read(buffer) must return
+// an awaitable producing the number of bytes read into buffer, 0 at the end
+// of the stream, e.g. a recv() driven by epoll or io_uring. Received bytes
+// are framed in a CopyDataFramer of the given capacity, allocated once when
+// the stream starts, and every event parsed from them is yielded before
+// read is awaited again, so the stream only suspends on its source when its
+// buffer runs out of complete messages. Keepalives are passed to
+// onKeepalive. A parse or framing error is yielded and ends the stream, as
+// does CopyDone. A read returning 0 while part of a message is buffered
+// yields TRUNCATED_STREAM.
+//
+// Events borrow from the framer's buffer with BORROWED or LAZY storage and
+// are valid until the following next(). Parsing uses resource, so pass an
+// arena (see TransactionArena) to keep OWNED events from allocating.
+template <typename Context, typename Read,
+          typename OnKeepalive = IgnoreKeepalives>
+AsyncGenerator<std::expected<typename Context::Event, ParseError>>
+streamEvents(
+    Read read, OnKeepalive onKeepalive = {},
+    std::size_t capacity = CopyDataFramer::defaultCapacity,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    using Result = std::expected<typename Context::Event, ParseError>;
+    CopyDataFramer framer(capacity);
+    while (true) {
+        while (true) {
+            const auto frame = framer.nextFrame();
+            if (!frame.has_value()) {
+                co_yield Result(std::unexpected(frame.error()));
+                co_return;
+            };
+            if (!frame.value().has_value()) break;
+            const auto &[type, payload] = frame.value().value();
+            if (type == static_cast<char>(CopyMessageType::CopyDone)) {
+                co_return;
+            };
+            if (type != static_cast<char>(CopyMessageType::CopyData)) {
+                co_yield Result(std::unexpected(ParseError{
+                    .code = ParseErrorCode::UNEXPECTED_TYPE,
+                    .eventType = type }));
+                co_return;
+            };
+            auto primary = primaryEventFromNetworkBuffer(payload);
+            if (!primary.has_value()) {
+                auto error = primary.error();
+                error.offset += CopyDataFramer::headerSize;
+                co_yield Result(std::unexpected(error));
+                co_return;
+            };
+            if (const auto *keepalive =
+                    std::get_if<PrimaryKeepaliveMessage>(&primary.value())) {
+                onKeepalive(*keepalive);
+                continue;
+            };
+            auto event = Context::parseEvent(
+                std::get<XLogData>(primary.value()).walData, resource);
+            const auto failed = !event.has_value();
+            co_yield event;
+            if (failed) co_return;
+        };
+        const std::size_t size = co_await read(framer.writable());
+        if (size == 0) {
+            if (framer.buffered() != 0) {
+                co_yield Result(std::unexpected(ParseError{
+                    .code = ParseErrorCode::TRUNCATED_STREAM,
+                    .receivedSize =
+                        static_cast<std::uint32_t>(framer.buffered()) }));
+            };
+            co_return;
+        };
+        framer.commit(size);
+    };
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
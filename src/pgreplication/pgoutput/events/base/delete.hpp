@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <format>
+#include <memory_resource>
 #include <optional>
 #include <span>
 
@@ -11,21 +12,26 @@
 #include "pgreplication/utils.hpp"
 
 namespace PGREPLICATION_NAMESPACE::pgoutput::events {
-template <BinaryValue Binary, StreamingEnabledValue Streaming>
+template <BinaryValue Binary, StreamingEnabledValue Streaming,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
 struct Delete;
 
-template <BinaryValue Binary>
-struct Delete<Binary, StreamingEnabledValue::ON> {
+template <BinaryValue Binary, TupleStorageValue Storage>
+struct Delete<Binary, StreamingEnabledValue::ON, Storage> {
     std::int32_t transactionId;
     std::int32_t oid;
-    std::optional<OldDataOrPrimaryKeyTupleData<Binary>> oldDataOrPrimaryKey;
+    std::optional<OldDataOrPrimaryKeyTupleData<Binary, Storage>>
+        oldDataOrPrimaryKey;
 
     constexpr static std::size_t minBufferSize =
         sizeof(transactionId) + sizeof(oid);
     using input_buffer = std::span<char>;
 
-    constexpr static Delete<Binary, StreamingEnabledValue::ON> fromBuffer(
-        const input_buffer &buffer) {
+    constexpr static Delete<Binary, StreamingEnabledValue::ON, Storage>
+    fromBuffer(
+        const input_buffer &buffer,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+        const TupleProjection *projection = nullptr) {
         const auto &transactionId =
             ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
                 buffer.subspan<0, 4>());
@@ -35,37 +41,62 @@ struct Delete<Binary, StreamingEnabledValue::ON> {
             .transactionId = transactionId,
             .oid = oid,
             .oldDataOrPrimaryKey =
-                parseOldDataOrPrimaryKey<Binary>(buffer.subspan<8>()).first
+                parseOldDataOrPrimaryKey<Binary, Storage>(
+                    buffer.subspan<8>(), resource, projection)
+                    .first
         };
     };
+
+    Delete<Binary, StreamingEnabledValue::ON> materialize() const {
+        return { .transactionId = transactionId,
+                 .oid = oid,
+                 .oldDataOrPrimaryKey =
+                     materializeOldDataOrPrimaryKey<Binary, Storage>(
+                         oldDataOrPrimaryKey) };
+    };
 };
 
-template <BinaryValue Binary>
-struct Delete<Binary, StreamingEnabledValue::OFF> {
+template <BinaryValue Binary, TupleStorageValue Storage>
+struct Delete<Binary, StreamingEnabledValue::OFF, Storage> {
     std::int32_t oid;
-    std::optional<OldDataOrPrimaryKeyTupleData<Binary>> oldDataOrPrimaryKey;
+    std::optional<OldDataOrPrimaryKeyTupleData<Binary, Storage>>
+        oldDataOrPrimaryKey;
 
     constexpr static std::size_t minBufferSize = sizeof(oid);
     using input_buffer = std::span<char>;
 
-    constexpr static Delete<Binary, StreamingEnabledValue::OFF> fromBuffer(
-        const input_buffer &buffer) {
+    constexpr static Delete<Binary, StreamingEnabledValue::OFF, Storage>
+    fromBuffer(
+        const input_buffer &buffer,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+        const TupleProjection *projection = nullptr) {
         const auto &oid = ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
             buffer.subspan<0, 4>());
         return {
             .oid = oid,
             .oldDataOrPrimaryKey =
-                parseOldDataOrPrimaryKey<Binary>(buffer.subspan<4>()).first,
+                parseOldDataOrPrimaryKey<Binary, Storage>(
+                    buffer.subspan<4>(), resource, projection)
+                    .first,
         };
     };
+
+    Delete<Binary, StreamingEnabledValue::OFF> materialize() const {
+        return { .oid = oid,
+                 .oldDataOrPrimaryKey =
+                     materializeOldDataOrPrimaryKey<Binary, Storage>(
+                         oldDataOrPrimaryKey) };
+    };
 };
 
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
 
 namespace std {
-template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary>
+template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary,
+          PGREPLICATION_NAMESPACE::pgoutput::TupleStorageValue Storage>
 struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Delete<
-    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON>> {
+    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON,
+    Storage>> {
     template <typename ParseContext>
     constexpr auto parse(ParseContext &ctx) {
         return ctx.begin();
@@ -75,8 +106,8 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Delete<
     auto format(
         const PGREPLICATION_NAMESPACE::pgoutput::events::Delete<
             Binary,
-            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON>
-            &record,
+            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON,
+            Storage> &record,
         FormatContext &ctx) const {
         return format_to(
             ctx.out(),
@@ -85,9 +116,11 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Delete<
     }
 };
 
-template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary>
+template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary,
+          PGREPLICATION_NAMESPACE::pgoutput::TupleStorageValue Storage>
 struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Delete<
-    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF>> {
+    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF,
+    Storage>> {
     template <typename ParseContext>
     constexpr auto parse(ParseContext &ctx) {
         return ctx.begin();
@@ -97,8 +130,8 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Delete<
     auto format(
         const PGREPLICATION_NAMESPACE::pgoutput::events::Delete<
             Binary,
-            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF>
-            &record,
+            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF,
+            Storage> &record,
         FormatContext &ctx) const {
         return format_to(ctx.out(), "Delete(oid: {}, oldDataOrPrimaryKey: {})",
                          record.oid, record.oldDataOrPrimaryKey);
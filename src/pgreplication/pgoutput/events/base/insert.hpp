@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <format>
+#include <memory_resource>
 #include <span>
 
 #include "./tuple_data.hpp"
@@ -10,57 +11,81 @@
 #include "pgreplication/utils.hpp"
 
 namespace PGREPLICATION_NAMESPACE::pgoutput::events {
-template <BinaryValue Binary, StreamingEnabledValue Streaming>
+template <BinaryValue Binary, StreamingEnabledValue Streaming,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
 struct Insert;
 
-template <BinaryValue Binary>
-struct Insert<Binary, StreamingEnabledValue::ON> {
+template <BinaryValue Binary, TupleStorageValue Storage>
+struct Insert<Binary, StreamingEnabledValue::ON, Storage> {
     std::int32_t transactionId;
     std::int32_t oid;
-    TupleData<Binary> data;
+    StoredTupleData<Binary, Storage> data;
 
     constexpr static std::size_t minBufferSize =
         sizeof(transactionId) + sizeof(oid) + sizeof(std::int16_t);
     using input_buffer = std::span<char>;
 
-    constexpr static Insert<Binary, StreamingEnabledValue::ON> fromBuffer(
-        const input_buffer &buffer) {
+    constexpr static Insert<Binary, StreamingEnabledValue::ON, Storage>
+    fromBuffer(
+        const input_buffer &buffer,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+        const TupleProjection *projection = nullptr) {
         return {
             .transactionId = ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
                 buffer.subspan<0, 4>()),
             .oid = ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
                 buffer.subspan<4, 4>()),
-            .data =
-                parseTupleData<Binary>(buffer.subspan<8 + sizeof('N')>()).first
+            .data = parseStoredTupleData<Binary, Storage>(
+                        buffer.subspan<8 + sizeof('N')>(), resource,
+                        projection)
+                        .first
         };
     };
+
+    Insert<Binary, StreamingEnabledValue::ON> materialize() const {
+        return { .transactionId = transactionId,
+                 .oid = oid,
+                 .data = events::materialize<Binary>(data) };
+    };
 };
 
-template <BinaryValue Binary>
-struct Insert<Binary, StreamingEnabledValue::OFF> {
+template <BinaryValue Binary, TupleStorageValue Storage>
+struct Insert<Binary, StreamingEnabledValue::OFF, Storage> {
     std::int32_t oid;
-    TupleData<Binary> data;
+    StoredTupleData<Binary, Storage> data;
 
     constexpr static std::size_t minBufferSize =
         sizeof(oid) + sizeof(std::int16_t);
     using input_buffer = std::span<char>;
 
-    constexpr static Insert<Binary, StreamingEnabledValue::OFF> fromBuffer(
-        const input_buffer &buffer) {
+    constexpr static Insert<Binary, StreamingEnabledValue::OFF, Storage>
+    fromBuffer(
+        const input_buffer &buffer,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+        const TupleProjection *projection = nullptr) {
         return {
             .oid = ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
                 buffer.subspan<0, 4>()),
-            .data =
-                parseTupleData<Binary>(buffer.subspan<4 + sizeof('N')>()).first
+            .data = parseStoredTupleData<Binary, Storage>(
+                        buffer.subspan<4 + sizeof('N')>(), resource,
+                        projection)
+                        .first
         };
     };
+
+    Insert<Binary, StreamingEnabledValue::OFF> materialize() const {
+        return { .oid = oid,
+                 .data = events::materialize<Binary>(data) };
+    };
 };
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
 
 namespace std {
-template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary>
+template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary,
+          PGREPLICATION_NAMESPACE::pgoutput::TupleStorageValue Storage>
 struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Insert<
-    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON>> {
+    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON,
+    Storage>> {
     template <typename ParseContext>
     constexpr auto parse(ParseContext &ctx) {
         return ctx.begin();
@@ -70,8 +95,8 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Insert<
     auto format(
         const PGREPLICATION_NAMESPACE::pgoutput::events::Insert<
             Binary,
-            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON>
-            &record,
+            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON,
+            Storage> &record,
         FormatContext &ctx) const {
         return format_to(ctx.out(),
                               "Insert(transactionId: {}, oid: {}, data: {})",
@@ -79,9 +104,11 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Insert<
     }
 };
 
-template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary>
+template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary,
+          PGREPLICATION_NAMESPACE::pgoutput::TupleStorageValue Storage>
 struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Insert<
-    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF>> {
+    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF,
+    Storage>> {
     template <typename ParseContext>
     constexpr auto parse(ParseContext &ctx) {
         return ctx.begin();
@@ -91,8 +118,8 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Insert<
     auto format(
         const PGREPLICATION_NAMESPACE::pgoutput::events::Insert<
             Binary,
-            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF>
-            &record,
+            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF,
+            Storage> &record,
         FormatContext &ctx) const {
         return format_to(ctx.out(), "Insert(oid: {}, data: {})",
                               record.oid, record.data);
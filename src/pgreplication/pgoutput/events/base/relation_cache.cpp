@@ -0,0 +1,135 @@
+#include "./relation_cache.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "./relation_column.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput::events {
+
+std::optional<std::size_t> RelationSchema::columnIndex(
+    std::string_view columnName) const {
+    for (std::size_t index = 0; index < columns.size(); index++) {
+        if (columns[index].name == columnName) return index;
+    };
+    return std::nullopt;
+};
+
+std::optional<RelationSchema> RelationCache::find(std::int32_t oid) const {
+    const auto &it = entryIndexes.find(oid);
+    if (it == entryIndexes.end()) return std::nullopt;
+    return schema(entries[it->second]);
+};
+
+std::optional<CachedType> RelationCache::findType(std::int32_t oid) const {
+    const auto &it = types.find(oid);
+    if (it == types.end()) return std::nullopt;
+    return it->second;
+};
+
+void RelationCache::erase(std::int32_t oid) {
+    const auto &it = entryIndexes.find(oid);
+    if (it == entryIndexes.end()) return;
+    const auto index = it->second;
+    deadColumns += entries[index].columnsCount;
+    entryIndexes.erase(it);
+    if (index != entries.size() - 1) {
+        entries[index] = entries.back();
+        entryIndexes[entries[index].oid] = index;
+    };
+    entries.pop_back();
+};
+
+void RelationCache::clear() {
+    entries.clear();
+    entryIndexes.clear();
+    columns.clear();
+    keyColumns.clear();
+    deadColumns = 0;
+    types.clear();
+};
+
+RelationSchema RelationCache::store(
+    std::int32_t oid, std::string_view relationNamespace, std::string_view name,
+    std::int8_t replicaIdentity,
+    std::span<const RelationColumn> relationColumns) {
+    Entry entry = {
+        .oid = oid,
+        .relationNamespace = intern(relationNamespace),
+        .name = intern(name),
+        .replicaIdentity = replicaIdentity,
+        .columnsBegin = static_cast<std::uint32_t>(columns.size()),
+        .columnsCount = static_cast<std::uint16_t>(relationColumns.size()),
+        .keyColumnsBegin = static_cast<std::uint32_t>(keyColumns.size()),
+        .keyColumnsCount = 0,
+    };
+    columns.reserve(columns.size() + relationColumns.size());
+    for (std::size_t index = 0; index < relationColumns.size(); index++) {
+        const auto &column = columns.emplace_back(CachedRelationColumn{
+            .flags = relationColumns[index].flags,
+            .name = intern(relationColumns[index].name),
+            .oid = relationColumns[index].oid,
+            .typeModifier = relationColumns[index].typeModifier });
+        if (column.isKey()) {
+            keyColumns.push_back(static_cast<std::uint16_t>(index));
+            entry.keyColumnsCount++;
+        };
+    };
+
+    const auto &[it, inserted] = entryIndexes.try_emplace(oid, entries.size());
+    if (inserted) {
+        entries.push_back(entry);
+    } else {
+        deadColumns += entries[it->second].columnsCount;
+        entries[it->second] = entry;
+    };
+    if (deadColumns > columns.size() / 2) compact();
+    return schema(entries[entryIndexes.at(oid)]);
+};
+
+RelationSchema RelationCache::schema(const Entry &entry) const {
+    return {
+        .oid = entry.oid,
+        .relationNamespace = entry.relationNamespace,
+        .name = entry.name,
+        .replicaIdentity = entry.replicaIdentity,
+        .columns = std::span(columns).subspan(entry.columnsBegin,
+                                              entry.columnsCount),
+        .keyColumns = std::span(keyColumns).subspan(entry.keyColumnsBegin,
+                                                    entry.keyColumnsCount),
+    };
+};
+
+std::string_view RelationCache::intern(std::string_view value) {
+    const auto &it = internedStrings.find(value);
+    if (it != internedStrings.end()) return *it;
+    return *internedStrings.emplace(strings.emplace_back(value)).first;
+};
+
+void RelationCache::compact() {
+    std::vector<CachedRelationColumn> liveColumns;
+    std::vector<std::uint16_t> liveKeyColumns;
+    liveColumns.reserve(columns.size() - deadColumns);
+    for (auto &entry : entries) {
+        const auto &entryColumns =
+            std::span(columns).subspan(entry.columnsBegin, entry.columnsCount);
+        const auto &entryKeyColumns = std::span(keyColumns).subspan(
+            entry.keyColumnsBegin, entry.keyColumnsCount);
+        entry.columnsBegin = static_cast<std::uint32_t>(liveColumns.size());
+        entry.keyColumnsBegin =
+            static_cast<std::uint32_t>(liveKeyColumns.size());
+        liveColumns.insert(liveColumns.end(), entryColumns.begin(),
+                           entryColumns.end());
+        liveKeyColumns.insert(liveKeyColumns.end(), entryKeyColumns.begin(),
+                              entryKeyColumns.end());
+    };
+    columns = std::move(liveColumns);
+    keyColumns = std::move(liveKeyColumns);
+    deadColumns = 0;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "./relation.hpp"
+#include "./relation_column.hpp"
+#include "./type.hpp"
+#include "pgreplication/pgoutput/options.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput::events {
+struct CachedRelationColumn {
+    std::int8_t flags;
+    std::string_view name;
+    std::int32_t oid;
+    std::int32_t typeModifier;
+
+    constexpr bool isKey() const { return (flags & 1) != 0; };
+};
+
+// Views into a RelationCache. They are invalidated by the next apply(),
+// erase() or clear() on the cache they came from.
+struct RelationSchema {
+    std::int32_t oid;
+    std::string_view relationNamespace;
+    std::string_view name;
+    std::int8_t replicaIdentity;
+    std::span<const CachedRelationColumn> columns;
+    std::span<const std::uint16_t> keyColumns;
+
+    std::optional<std::size_t> columnIndex(std::string_view columnName) const;
+};
+
+struct CachedType {
+    std::string_view typeNamespace;
+    std::string_view name;
+};
+
+// Tracks the schema announced by Relation messages so Insert/Update/Delete
+// tuples can be interpreted by oid. pgoutput resends a Relation whenever the
+// definition changed (and after reconnecting), so apply() always replaces the
+// previous entry; Type messages do the same for custom type names. Names are
+// interned for the lifetime of the cache and columns of all relations are
+// kept in one flat array that is compacted once replaced entries dominate.
+class RelationCache {
+   public:
+    template <StreamingEnabledValue Streaming>
+    RelationSchema apply(const Relation<Streaming> &relation) {
+        return store(relation.oid, relation.relationNamespace, relation.name,
+                     relation.replicaIdentity, relation.columns);
+    };
+
+    template <StreamingEnabledValue Streaming>
+    void apply(const Type<Streaming> &type) {
+        types.insert_or_assign(type.oid,
+                               CachedType{ .typeNamespace = intern(
+                                               type.typeNamespace),
+                                           .name = intern(type.name) });
+    };
+
+    std::optional<RelationSchema> find(std::int32_t oid) const;
+    std::optional<CachedType> findType(std::int32_t oid) const;
+
+    void erase(std::int32_t oid);
+    void clear();
+    std::size_t size() const { return entryIndexes.size(); };
+
+   private:
+    struct Entry {
+        std::int32_t oid;
+        std::string_view relationNamespace;
+        std::string_view name;
+        std::int8_t replicaIdentity;
+        std::uint32_t columnsBegin;
+        std::uint16_t columnsCount;
+        std::uint32_t keyColumnsBegin;
+        std::uint16_t keyColumnsCount;
+    };
+
+    RelationSchema store(std::int32_t oid, std::string_view relationNamespace,
+                         std::string_view name, std::int8_t replicaIdentity,
+                         std::span<const RelationColumn> relationColumns);
+    RelationSchema schema(const Entry &entry) const;
+    std::string_view intern(std::string_view value);
+    void compact();
+
+    std::deque<std::string> strings;
+    std::unordered_set<std::string_view> internedStrings;
+    std::vector<Entry> entries;
+    std::unordered_map<std::int32_t, std::size_t> entryIndexes;
+    std::vector<CachedRelationColumn> columns;
+    std::vector<std::uint16_t> keyColumns;
+    std::size_t deadColumns = 0;
+    std::unordered_map<std::int32_t, CachedType> types;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
@@ -25,7 +25,9 @@ Truncate<StreamingEnabledValue::ON>::fromBuffer(const std::span<char> &buffer) {
                          (index + 1) * sizeof(std::int32_t))
                 .subspan<0, 4>());
     };
-    return { .transactionId = transactionId, .flags = flags, .oids = oids };
+    return { .transactionId = transactionId,
+             .flags = flags,
+             .oids = std::move(oids) };
 };
 
 Truncate<StreamingEnabledValue::OFF> Truncate<
@@ -43,6 +45,6 @@ Truncate<StreamingEnabledValue::OFF> Truncate<
                          (index + 1) * sizeof(std::int32_t))
                 .subspan<0, 4>());
     };
-    return { .flags = flags, .oids = oids };
+    return { .flags = flags, .oids = std::move(oids) };
 };
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
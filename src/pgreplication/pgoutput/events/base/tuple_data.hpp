@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <format>
+#include <memory>
+#include <memory_resource>
 #include <optional>
 #include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -28,9 +34,41 @@ using TupleDataColumn =
 template <BinaryValue Binary>
 using TupleData = std::vector<TupleDataColumn<Binary>>;
 
+// Arena columns own their values like TupleDataColumn but allocate them from
+// the memory_resource they were parsed with (see TransactionArena), so they
+// are only valid as long as that resource is.
 template <BinaryValue Binary>
-constexpr std::pair<TupleDataColumn<Binary>, unsigned int> parseTupleColumn(
-    const std::span<char> &buffer) {
+using ArenaTupleDataColumn =
+    std::variant<PGNull, PGUnchangedToastedValue,
+                 std::conditional_t<Binary == BinaryValue::ON,
+                                    std::pmr::vector<std::byte>,
+                                    std::pmr::string>>;
+
+template <BinaryValue Binary>
+using ArenaTupleData = std::pmr::vector<ArenaTupleDataColumn<Binary>>;
+
+// Borrowed columns point into the buffer the event was parsed from (normally
+// XLogData::walData) and are only valid while that buffer is alive. Use
+// materialize to copy them into a TupleDataColumn/TupleData.
+template <BinaryValue Binary>
+using TupleDataColumnView =
+    std::variant<PGNull, PGUnchangedToastedValue,
+                 std::conditional_t<Binary == BinaryValue::ON,
+                                    std::span<const std::byte>,
+                                    std::string_view>>;
+
+template <BinaryValue Binary>
+using TupleDataView = std::pmr::vector<TupleDataColumnView<Binary>>;
+
+// Borrowed binary column bytes for std::format, printed like the owned
+// std::vector<std::byte> columns.
+struct FormattedBytes {
+    std::span<const std::byte> bytes;
+};
+
+template <BinaryValue Binary>
+constexpr std::pair<TupleDataColumnView<Binary>, unsigned int>
+parseTupleColumnView(const std::span<char> &buffer) {
     const auto &c = buffer.front();
     switch (c) {
         case 'n':
@@ -43,65 +81,582 @@ constexpr std::pair<TupleDataColumn<Binary>, unsigned int> parseTupleColumn(
     const auto &valueBuffer = buffer.subspan(5, valueSize);
     if constexpr (Binary == BinaryValue::ON) {
         assert(c == 'b');
-        return { std::vector<std::byte>(
-                     reinterpret_cast<std::byte *>(valueBuffer.begin().base()),
-                     reinterpret_cast<std::byte *>(valueBuffer.end().base())),
-                 5 + valueSize };
+        return { std::as_bytes(valueBuffer), 5 + valueSize };
     } else {
         assert(c == 't');
-        return { std::string(valueBuffer.begin(), valueBuffer.end()),
+        return { std::string_view(valueBuffer.data(), valueBuffer.size()),
                  5 + valueSize };
     };
 };
 
+// Copies the column into a Column (TupleDataColumn or ArenaTupleDataColumn);
+// resource is only used by the std::pmr columns.
+template <BinaryValue Binary, typename Column = TupleDataColumn<Binary>>
+constexpr Column materializeTupleColumn(
+    const TupleDataColumnView<Binary> &column,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    return std::visit(
+        [resource](const auto &value) -> Column {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, PGNull> ||
+                          std::is_same_v<T, PGUnchangedToastedValue>) {
+                return value;
+            } else {
+                return std::make_obj_using_allocator<
+                    std::variant_alternative_t<2, Column>>(
+                    std::pmr::polymorphic_allocator<>(resource),
+                    value.begin(), value.end());
+            };
+        },
+        column);
+};
+
+template <BinaryValue Binary, typename Column>
+constexpr TupleDataColumnView<Binary> viewTupleColumn(const Column &column) {
+    return std::visit(
+        [](const auto &value) -> TupleDataColumnView<Binary> {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, PGNull> ||
+                          std::is_same_v<T, PGUnchangedToastedValue>) {
+                return value;
+            } else if constexpr (Binary == BinaryValue::ON) {
+                return std::span<const std::byte>(value);
+            } else {
+                return std::string_view(value);
+            };
+        },
+        column);
+};
+
+template <BinaryValue Binary, typename Column = TupleDataColumn<Binary>>
+constexpr std::pair<Column, unsigned int> parseTupleColumn(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    const auto &[column, readBytes] = parseTupleColumnView<Binary>(buffer);
+    return { materializeTupleColumn<Binary, Column>(column, resource),
+             readBytes };
+};
+
+template <typename Data, auto parseColumn>
+constexpr std::pair<Data, unsigned int> parseTupleColumns(
+    const std::span<char> &buffer, std::pmr::memory_resource *resource) {
+    auto data = std::make_obj_using_allocator<Data>(
+        std::pmr::polymorphic_allocator<>(resource));
+    const auto &columnSize = ::PGREPLICATION_NAMESPACE::utils::int16FromNetwork(
+        buffer.subspan<0, 2>());
+    data.reserve(columnSize);
+    unsigned int bufferPosition = 2;
+    for (std::int16_t index = 0; index < columnSize; index++) {
+        auto [column, readBytes] = [&]() {
+            if constexpr (std::is_invocable_v<decltype(parseColumn),
+                                              std::span<char>,
+                                              std::pmr::memory_resource *>) {
+                return parseColumn(buffer.subspan(bufferPosition), resource);
+            } else {
+                return parseColumn(buffer.subspan(bufferPosition));
+            };
+        }();
+        data.emplace_back(std::move(column));
+        bufferPosition += readBytes;
+    };
+    return { std::move(data), bufferPosition };
+};
+
 template <BinaryValue Binary>
 constexpr std::pair<TupleData<Binary>, unsigned int> parseTupleData(
-    const std::span<char> &buffer) {
-    TupleData<Binary> data;
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    return parseTupleColumns<TupleData<Binary>, parseTupleColumn<Binary>>(
+        buffer, resource);
+};
+
+template <BinaryValue Binary>
+constexpr std::pair<ArenaTupleData<Binary>, unsigned int> parseArenaTupleData(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    return parseTupleColumns<
+        ArenaTupleData<Binary>,
+        parseTupleColumn<Binary, ArenaTupleDataColumn<Binary>>>(buffer,
+                                                                resource);
+};
+
+template <BinaryValue Binary>
+constexpr std::pair<TupleDataView<Binary>, unsigned int> parseTupleDataView(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    return parseTupleColumns<TupleDataView<Binary>,
+                             parseTupleColumnView<Binary>>(buffer, resource);
+};
+
+template <BinaryValue Binary>
+TupleData<Binary> materialize(const TupleData<Binary> &data) {
+    return data;
+};
+
+template <BinaryValue Binary>
+TupleData<Binary> materialize(const ArenaTupleData<Binary> &data) {
+    TupleData<Binary> result;
+    result.reserve(data.size());
+    for (const auto &column : data) {
+        result.emplace_back(
+            materializeTupleColumn<Binary>(viewTupleColumn<Binary>(column)));
+    };
+    return result;
+};
+
+template <BinaryValue Binary>
+TupleData<Binary> materialize(const TupleDataView<Binary> &data) {
+    TupleData<Binary> result;
+    result.reserve(data.size());
+    for (const auto &column : data) {
+        result.emplace_back(materializeTupleColumn<Binary>(column));
+    };
+    return result;
+};
+
+// Lazy tuples only record where each column starts; a column is decoded into
+// a TupleDataColumnView when it is accessed. Like TupleDataView they borrow
+// the buffer the event was parsed from.
+template <BinaryValue Binary>
+struct LazyTupleData {
+    std::span<char> buffer;
+    std::pmr::vector<std::uint32_t> offsets;
+
+    std::size_t size() const { return offsets.size(); };
+
+    TupleDataColumnView<Binary> operator[](std::size_t index) const {
+        return parseTupleColumnView<Binary>(buffer.subspan(offsets[index]))
+            .first;
+    };
+
+    TupleDataColumnView<Binary> at(std::size_t index) const {
+        if (index >= offsets.size()) {
+            throw std::out_of_range(
+                std::format("column index {} is out of range for {} columns",
+                            index, offsets.size()));
+        };
+        return (*this)[index];
+    };
+};
+
+template <BinaryValue Binary>
+constexpr std::pair<LazyTupleData<Binary>, unsigned int> parseLazyTupleData(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    std::pmr::vector<std::uint32_t> offsets(resource);
     const auto &columnSize = ::PGREPLICATION_NAMESPACE::utils::int16FromNetwork(
         buffer.subspan<0, 2>());
+    offsets.reserve(columnSize);
     unsigned int bufferPosition = 2;
     for (std::int16_t index = 0; index < columnSize; index++) {
-        const auto &[column, readBytes] =
-            parseTupleColumn<Binary>(buffer.subspan(bufferPosition));
-        data.emplace_back(column);
-        bufferPosition += readBytes;
+        offsets.push_back(bufferPosition);
+        const auto &c = buffer[bufferPosition];
+        if (c == 'n' || c == 'u') {
+            bufferPosition += 1;
+            continue;
+        };
+        const auto &valueSize =
+            ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
+                buffer.subspan(bufferPosition + 1).first<4>());
+        bufferPosition += 5 + valueSize;
     };
-    return { data, bufferPosition };
+    return { { .buffer = buffer.first(bufferPosition),
+               .offsets = std::move(offsets) },
+             bufferPosition };
 };
 
 template <BinaryValue Binary>
-using OldTupleData = TupleData<Binary>;
+TupleData<Binary> materialize(const LazyTupleData<Binary> &data) {
+    TupleData<Binary> result;
+    result.reserve(data.size());
+    for (std::size_t index = 0; index < data.size(); index++) {
+        result.emplace_back(materializeTupleColumn<Binary>(data[index]));
+    };
+    return result;
+};
+
+enum class PackedColumnKind : std::uint8_t {
+    NULL_VALUE,
+    UNCHANGED_TOASTED_VALUE,
+    INLINE,
+    OUT_OF_LINE
+};
+
+// Values of up to inlineCapacity bytes are stored in the header in place of
+// the offset of their out of line bytes.
+struct PackedColumnHeader {
+    constexpr static std::size_t inlineCapacity = 8;
+
+    PackedColumnKind kind;
+    std::uint32_t size;
+    union {
+        std::uint32_t offset;
+        char inlineValue[inlineCapacity];
+    };
+};
+
+// Packed tuples own their columns like TupleData, but keep them in a single
+// allocation per row: one PackedColumnHeader per column followed by the
+// values that do not fit in their header. Columns are returned as
+// TupleDataColumnView pointing into the tuple, so they are valid as long as
+// the tuple is neither modified nor destroyed.
 template <BinaryValue Binary>
-using PrimaryKeyTupleData = TupleData<Binary>;
+struct PackedTupleData {
+    std::pmr::vector<char> storage;
+    std::uint16_t columns = 0;
+
+    std::size_t size() const { return columns; };
 
+    TupleDataColumnView<Binary> operator[](std::size_t index) const {
+        PackedColumnHeader header;
+        const auto *position = storage.data() + index * sizeof(header);
+        std::memcpy(&header, position, sizeof(header));
+        const auto *value = storage.data();
+        switch (header.kind) {
+            case PackedColumnKind::NULL_VALUE:
+                return PGNull{};
+            case PackedColumnKind::UNCHANGED_TOASTED_VALUE:
+                return PGUnchangedToastedValue{};
+            case PackedColumnKind::INLINE:
+                value =
+                    position + offsetof(PackedColumnHeader, inlineValue);
+                break;
+            case PackedColumnKind::OUT_OF_LINE:
+                value += header.offset;
+                break;
+        };
+        if constexpr (Binary == BinaryValue::ON) {
+            return std::span<const std::byte>(
+                reinterpret_cast<const std::byte *>(value), header.size);
+        } else {
+            return std::string_view(value, header.size);
+        };
+    };
+
+    TupleDataColumnView<Binary> at(std::size_t index) const {
+        if (index >= columns) {
+            throw std::out_of_range(
+                std::format("column index {} is out of range for {} columns",
+                            index, columns));
+        };
+        return (*this)[index];
+    };
+};
+
+// Walks the tuple twice: once to size the row, once to fill it, so each
+// row costs exactly one allocation.
 template <BinaryValue Binary>
-using OldDataOrPrimaryKeyTupleData =
-    std::variant<OldTupleData<Binary>, PrimaryKeyTupleData<Binary>>;
+std::pair<PackedTupleData<Binary>, unsigned int> parsePackedTupleData(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    const auto &columnSize = ::PGREPLICATION_NAMESPACE::utils::int16FromNetwork(
+        buffer.subspan<0, 2>());
+    const auto &columns =
+        static_cast<std::uint16_t>(std::max<std::int16_t>(columnSize, 0));
+    std::size_t outOfLineSize = 0;
+    unsigned int bufferPosition = 2;
+    for (std::uint16_t index = 0; index < columns; index++) {
+        const auto &c = buffer[bufferPosition];
+        if (c == 'n' || c == 'u') {
+            bufferPosition += 1;
+            continue;
+        };
+        const auto &valueSize = static_cast<std::uint32_t>(
+            ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
+                buffer.subspan(bufferPosition + 1).first<4>()));
+        if (valueSize > PackedColumnHeader::inlineCapacity) {
+            outOfLineSize += valueSize;
+        };
+        bufferPosition += 5 + valueSize;
+    };
+
+    PackedTupleData<Binary> data{
+        .storage = std::pmr::vector<char>(
+            columns * sizeof(PackedColumnHeader) + outOfLineSize, resource),
+        .columns = columns,
+    };
+    auto *headers = data.storage.data();
+    auto outOfLineOffset =
+        static_cast<std::uint32_t>(columns * sizeof(PackedColumnHeader));
+    bufferPosition = 2;
+    for (std::uint16_t index = 0; index < columns; index++) {
+        PackedColumnHeader header = { .kind = PackedColumnKind::NULL_VALUE,
+                                      .size = 0,
+                                      .offset = 0 };
+        const auto &c = buffer[bufferPosition];
+        if (c == 'n' || c == 'u') {
+            if (c == 'u') {
+                header.kind = PackedColumnKind::UNCHANGED_TOASTED_VALUE;
+            };
+            bufferPosition += 1;
+        } else {
+            header.size = static_cast<std::uint32_t>(
+                ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
+                    buffer.subspan(bufferPosition + 1).first<4>()));
+            const auto *value = buffer.data() + bufferPosition + 5;
+            if (header.size <= PackedColumnHeader::inlineCapacity) {
+                header.kind = PackedColumnKind::INLINE;
+                std::memcpy(header.inlineValue, value, header.size);
+            } else {
+                header.kind = PackedColumnKind::OUT_OF_LINE;
+                header.offset = outOfLineOffset;
+                std::memcpy(data.storage.data() + outOfLineOffset, value,
+                            header.size);
+                outOfLineOffset += header.size;
+            };
+            bufferPosition += 5 + header.size;
+        };
+        std::memcpy(headers + index * sizeof(header), &header,
+                    sizeof(header));
+    };
+    return { std::move(data), bufferPosition };
+};
+
+template <BinaryValue Binary>
+TupleData<Binary> materialize(const PackedTupleData<Binary> &data) {
+    TupleData<Binary> result;
+    result.reserve(data.size());
+    for (std::size_t index = 0; index < data.size(); index++) {
+        result.emplace_back(materializeTupleColumn<Binary>(data[index]));
+    };
+    return result;
+};
+
+template <BinaryValue Binary, TupleStorageValue Storage>
+struct TupleDataStorage;
+
+template <BinaryValue Binary>
+struct TupleDataStorage<Binary, TupleStorageValue::OWNED> {
+    using column_type = TupleDataColumn<Binary>;
+    using type = TupleData<Binary>;
+
+    constexpr static auto parse = parseTupleData<Binary>;
+};
+
+template <BinaryValue Binary>
+struct TupleDataStorage<Binary, TupleStorageValue::BORROWED> {
+    using column_type = TupleDataColumnView<Binary>;
+    using type = TupleDataView<Binary>;
+
+    constexpr static auto parse = parseTupleDataView<Binary>;
+};
+
+template <BinaryValue Binary>
+struct TupleDataStorage<Binary, TupleStorageValue::LAZY> {
+    using column_type = TupleDataColumnView<Binary>;
+    using type = LazyTupleData<Binary>;
+
+    constexpr static auto parse = parseLazyTupleData<Binary>;
+};
+
+template <BinaryValue Binary>
+struct TupleDataStorage<Binary, TupleStorageValue::PACKED> {
+    using column_type = TupleDataColumnView<Binary>;
+    using type = PackedTupleData<Binary>;
+
+    constexpr static auto parse = parsePackedTupleData<Binary>;
+};
+
+template <BinaryValue Binary>
+struct TupleDataStorage<Binary, TupleStorageValue::ARENA> {
+    using column_type = ArenaTupleDataColumn<Binary>;
+    using type = ArenaTupleData<Binary>;
+
+    constexpr static auto parse = parseArenaTupleData<Binary>;
+};
+
+template <BinaryValue Binary, TupleStorageValue Storage>
+using StoredTupleData = typename TupleDataStorage<Binary, Storage>::type;
+
+// Columns to keep when parsing the tuples of a relation; the others are
+// skipped without being copied. Projected tuples only contain the kept
+// columns, in relation order.
+struct TupleProjection {
+    std::vector<bool> columns;
+
+    bool keeps(std::size_t index) const {
+        return index < columns.size() && columns[index];
+    };
+};
+
+// Calls visit(index, column, offset) for every column of the tuple at the
+// start of buffer and returns the size of the tuple.
+template <BinaryValue Binary, typename Visit>
+unsigned int forEachTupleColumn(const std::span<char> &buffer,
+                                Visit &&visit) {
+    const auto &columnSize = ::PGREPLICATION_NAMESPACE::utils::int16FromNetwork(
+        buffer.subspan<0, 2>());
+    unsigned int bufferPosition = 2;
+    for (std::int16_t index = 0; index < columnSize; index++) {
+        const auto &[column, readBytes] =
+            parseTupleColumnView<Binary>(buffer.subspan(bufferPosition));
+        visit(static_cast<std::size_t>(index), column, bufferPosition);
+        bufferPosition += readBytes;
+    };
+    return bufferPosition;
+};
 
 template <BinaryValue Binary>
-std::pair<std::optional<OldDataOrPrimaryKeyTupleData<Binary>>, unsigned int>
-parseOldDataOrPrimaryKey(const std::span<char> &buffer) {
+PackedTupleData<Binary> packTupleData(
+    std::span<const TupleDataColumnView<Binary>> columns,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    const auto &valueSize = [](const auto &column) -> std::size_t {
+        return column.index() == 2 ? std::get<2>(column).size() : 0;
+    };
+    std::size_t outOfLineSize = 0;
+    for (const auto &column : columns) {
+        const auto &size = valueSize(column);
+        if (size > PackedColumnHeader::inlineCapacity) outOfLineSize += size;
+    };
+    PackedTupleData<Binary> data{
+        .storage = std::pmr::vector<char>(
+            columns.size() * sizeof(PackedColumnHeader) + outOfLineSize,
+            resource),
+        .columns = static_cast<std::uint16_t>(columns.size()),
+    };
+    auto outOfLineOffset = static_cast<std::uint32_t>(
+        columns.size() * sizeof(PackedColumnHeader));
+    for (std::size_t index = 0; index < columns.size(); index++) {
+        PackedColumnHeader header = { .kind = PackedColumnKind::NULL_VALUE,
+                                      .size = 0,
+                                      .offset = 0 };
+        if (std::holds_alternative<PGUnchangedToastedValue>(columns[index])) {
+            header.kind = PackedColumnKind::UNCHANGED_TOASTED_VALUE;
+        } else if (columns[index].index() == 2) {
+            const auto &value =
+                std::as_bytes(std::span(std::get<2>(columns[index])));
+            header.size = static_cast<std::uint32_t>(value.size());
+            if (value.size() <= PackedColumnHeader::inlineCapacity) {
+                header.kind = PackedColumnKind::INLINE;
+                std::memcpy(header.inlineValue, value.data(), value.size());
+            } else {
+                header.kind = PackedColumnKind::OUT_OF_LINE;
+                header.offset = outOfLineOffset;
+                std::memcpy(data.storage.data() + outOfLineOffset,
+                            value.data(), value.size());
+                outOfLineOffset += header.size;
+            };
+        };
+        std::memcpy(data.storage.data() + index * sizeof(header), &header,
+                    sizeof(header));
+    };
+    return data;
+};
+
+template <BinaryValue Binary, TupleStorageValue Storage>
+std::pair<StoredTupleData<Binary, Storage>, unsigned int>
+parseProjectedTupleData(
+    const std::span<char> &buffer, const TupleProjection &projection,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    if constexpr (Storage == TupleStorageValue::OWNED ||
+                  Storage == TupleStorageValue::ARENA) {
+        using Data = StoredTupleData<Binary, Storage>;
+        auto data = std::make_obj_using_allocator<Data>(
+            std::pmr::polymorphic_allocator<>(resource));
+        const auto &size = forEachTupleColumn<Binary>(
+            buffer, [&](std::size_t index, const auto &column, unsigned int) {
+                if (!projection.keeps(index)) return;
+                data.emplace_back(
+                    materializeTupleColumn<Binary, typename Data::value_type>(
+                        column, resource));
+            });
+        return { std::move(data), size };
+    } else if constexpr (Storage == TupleStorageValue::BORROWED ||
+                         Storage == TupleStorageValue::PACKED) {
+        TupleDataView<Binary> data(resource);
+        const auto &size = forEachTupleColumn<Binary>(
+            buffer, [&](std::size_t index, const auto &column, unsigned int) {
+                if (projection.keeps(index)) data.push_back(column);
+            });
+        if constexpr (Storage == TupleStorageValue::PACKED) {
+            return { packTupleData<Binary>(data, resource), size };
+        } else {
+            return { std::move(data), size };
+        };
+    } else {
+        std::pmr::vector<std::uint32_t> offsets(resource);
+        const auto &size = forEachTupleColumn<Binary>(
+            buffer,
+            [&](std::size_t index, const auto &, unsigned int offset) {
+                if (projection.keeps(index)) offsets.push_back(offset);
+            });
+        return { LazyTupleData<Binary>{ .buffer = buffer.first(size),
+                                        .offsets = std::move(offsets) },
+                 size };
+    };
+};
+
+// Parses the tuple into the session's storage, keeping only the projected
+// columns when a projection is given.
+template <BinaryValue Binary, TupleStorageValue Storage>
+std::pair<StoredTupleData<Binary, Storage>, unsigned int> parseStoredTupleData(
+    const std::span<char> &buffer, std::pmr::memory_resource *resource,
+    const TupleProjection *projection) {
+    if (projection == nullptr) {
+        return TupleDataStorage<Binary, Storage>::parse(buffer, resource);
+    };
+    return parseProjectedTupleData<Binary, Storage>(buffer, *projection,
+                                                    resource);
+};
+
+template <BinaryValue Binary,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
+using OldTupleData = StoredTupleData<Binary, Storage>;
+template <BinaryValue Binary,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
+using PrimaryKeyTupleData = StoredTupleData<Binary, Storage>;
+
+template <BinaryValue Binary,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
+using OldDataOrPrimaryKeyTupleData =
+    std::variant<OldTupleData<Binary, Storage>,
+                 PrimaryKeyTupleData<Binary, Storage>>;
+
+template <BinaryValue Binary,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
+std::pair<std::optional<OldDataOrPrimaryKeyTupleData<Binary, Storage>>,
+          unsigned int>
+parseOldDataOrPrimaryKey(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+    const TupleProjection *projection = nullptr) {
     if (buffer.size() == 0) return { std::nullopt, 0 };
     const auto &c = buffer.front();
     switch (c) {
         case 'K': {
-            const auto &[tupleData, readBytes] =
-                parseTupleData<Binary>(buffer.subspan<1>());
-            return { OldDataOrPrimaryKeyTupleData<Binary>(
-                         std::in_place_index<1>, tupleData),
+            auto [tupleData, readBytes] =
+                parseStoredTupleData<Binary, Storage>(buffer.subspan<1>(),
+                                                      resource, projection);
+            return { OldDataOrPrimaryKeyTupleData<Binary, Storage>(
+                         std::in_place_index<1>, std::move(tupleData)),
                      readBytes + 1 };
         }
         case 'O':
-            const auto &[tupleData, readBytes] =
-                parseTupleData<Binary>(buffer.subspan<1>());
-            return { OldDataOrPrimaryKeyTupleData<Binary>(
-                         std::in_place_index<0>, tupleData),
+            auto [tupleData, readBytes] =
+                parseStoredTupleData<Binary, Storage>(buffer.subspan<1>(),
+                                                      resource, projection);
+            return { OldDataOrPrimaryKeyTupleData<Binary, Storage>(
+                         std::in_place_index<0>, std::move(tupleData)),
                      readBytes + 1 };
     };
     return { std::nullopt, 0 };
 };
 
+template <BinaryValue Binary, TupleStorageValue Storage>
+std::optional<OldDataOrPrimaryKeyTupleData<Binary>>
+materializeOldDataOrPrimaryKey(
+    const std::optional<OldDataOrPrimaryKeyTupleData<Binary, Storage>>
+        &oldDataOrPrimaryKey) {
+    if (!oldDataOrPrimaryKey.has_value()) return std::nullopt;
+    const auto &value = oldDataOrPrimaryKey.value();
+    if (value.index() == 0) {
+        return OldDataOrPrimaryKeyTupleData<Binary>(
+            std::in_place_index<0>, materialize<Binary>(std::get<0>(value)));
+    };
+    return OldDataOrPrimaryKeyTupleData<Binary>(
+        std::in_place_index<1>, materialize<Binary>(std::get<1>(value)));
+};
+
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
 
 namespace std {
@@ -135,4 +690,96 @@ struct formatter<
         return format_to(ctx.out(), "PGUnchangedToastedValue");
     }
 };
+
+template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary>
+struct formatter<
+    PGREPLICATION_NAMESPACE::pgoutput::events::LazyTupleData<Binary>> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(
+        const PGREPLICATION_NAMESPACE::pgoutput::events::LazyTupleData<Binary>
+            &record,
+        FormatContext &ctx) const {
+        auto out = format_to(ctx.out(), "[");
+        for (std::size_t index = 0; index < record.size(); index++) {
+            if (index != 0) out = format_to(out, ", ");
+            out = format_to(out, "{}", record[index]);
+        };
+        return format_to(out, "]");
+    }
+};
+
+template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary>
+struct formatter<
+    PGREPLICATION_NAMESPACE::pgoutput::events::PackedTupleData<Binary>> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(
+        const PGREPLICATION_NAMESPACE::pgoutput::events::PackedTupleData<Binary>
+            &record,
+        FormatContext &ctx) const {
+        auto out = format_to(ctx.out(), "[");
+        for (std::size_t index = 0; index < record.size(); index++) {
+            if (index != 0) out = format_to(out, ", ");
+            out = format_to(out, "{}", record[index]);
+        };
+        return format_to(out, "]");
+    }
+};
+
+template <>
+struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::FormattedBytes> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(
+        const PGREPLICATION_NAMESPACE::pgoutput::events::FormattedBytes &record,
+        FormatContext &ctx) const {
+        return format_to(
+            ctx.out(), "{}",
+            span<const unsigned char>(
+                reinterpret_cast<const unsigned char *>(record.bytes.data()),
+                record.bytes.size()));
+    }
+};
+
+template <>
+struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::TupleDataColumnView<
+    PGREPLICATION_NAMESPACE::pgoutput::BinaryValue::ON>> {
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext &ctx) {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const PGREPLICATION_NAMESPACE::pgoutput::events::
+                    TupleDataColumnView<
+                        PGREPLICATION_NAMESPACE::pgoutput::BinaryValue::ON>
+                        &record,
+                FormatContext &ctx) const {
+        return std::visit(
+            PGREPLICATION_NAMESPACE::utils::overloaded{
+                [&ctx](const span<const byte> &bytes) {
+                    return format_to(
+                        ctx.out(), "{}",
+                        PGREPLICATION_NAMESPACE::pgoutput::events::
+                            FormattedBytes{ bytes });
+                },
+                [&ctx](const auto &value) {
+                    return format_to(ctx.out(), "{}", value);
+                } },
+            record);
+    }
+};
 };  // namespace std
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <format>
+#include <memory_resource>
 #include <optional>
 #include <span>
 
@@ -11,67 +12,98 @@
 #include "pgreplication/utils.hpp"
 
 namespace PGREPLICATION_NAMESPACE::pgoutput::events {
-template <BinaryValue Binary, StreamingEnabledValue Streaming>
+template <BinaryValue Binary, StreamingEnabledValue Streaming,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
 struct Update;
 
-template <BinaryValue Binary>
-struct Update<Binary, StreamingEnabledValue::ON> {
+template <BinaryValue Binary, TupleStorageValue Storage>
+struct Update<Binary, StreamingEnabledValue::ON, Storage> {
     std::int32_t transactionId;
     std::int32_t oid;
-    std::optional<OldDataOrPrimaryKeyTupleData<Binary>> oldDataOrPrimaryKey;
-    TupleData<Binary> data;
+    std::optional<OldDataOrPrimaryKeyTupleData<Binary, Storage>>
+        oldDataOrPrimaryKey;
+    StoredTupleData<Binary, Storage> data;
 
     constexpr static std::size_t minBufferSize =
         sizeof(transactionId) + sizeof(oid) + sizeof(std::int16_t);
     using input_buffer = std::span<char>;
 
-    constexpr static Update<Binary, StreamingEnabledValue::ON> fromBuffer(
-        const input_buffer &buffer) {
+    constexpr static Update<Binary, StreamingEnabledValue::ON, Storage>
+    fromBuffer(
+        const input_buffer &buffer,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+        const TupleProjection *projection = nullptr) {
         const auto &transactionId =
             ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
                 buffer.subspan<0, 4>());
         const auto &oid = ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
             buffer.subspan<4, 4>());
-        const auto &[oldDataOrPrimaryKey, readBytes] =
-            parseOldDataOrPrimaryKey<Binary>(buffer.subspan<8>());
+        auto [oldDataOrPrimaryKey, readBytes] =
+            parseOldDataOrPrimaryKey<Binary, Storage>(buffer.subspan<8>(),
+                                                      resource, projection);
         return { .transactionId = transactionId,
                  .oid = oid,
-                 .oldDataOrPrimaryKey = oldDataOrPrimaryKey,
-                 .data = parseTupleData<Binary>(
-                             buffer.subspan(8 + sizeof('N') + readBytes))
+                 .oldDataOrPrimaryKey = std::move(oldDataOrPrimaryKey),
+                 .data = parseStoredTupleData<Binary, Storage>(
+                             buffer.subspan(8 + sizeof('N') + readBytes),
+                             resource, projection)
                              .first };
     };
+
+    Update<Binary, StreamingEnabledValue::ON> materialize() const {
+        return { .transactionId = transactionId,
+                 .oid = oid,
+                 .oldDataOrPrimaryKey =
+                     materializeOldDataOrPrimaryKey<Binary, Storage>(
+                         oldDataOrPrimaryKey),
+                 .data = events::materialize<Binary>(data) };
+    };
 };
 
-template <BinaryValue Binary>
-struct Update<Binary, StreamingEnabledValue::OFF> {
+template <BinaryValue Binary, TupleStorageValue Storage>
+struct Update<Binary, StreamingEnabledValue::OFF, Storage> {
     std::int32_t oid;
-    std::optional<OldDataOrPrimaryKeyTupleData<Binary>> oldDataOrPrimaryKey;
-    TupleData<Binary> data;
+    std::optional<OldDataOrPrimaryKeyTupleData<Binary, Storage>>
+        oldDataOrPrimaryKey;
+    StoredTupleData<Binary, Storage> data;
 
     constexpr static std::size_t minBufferSize =
         sizeof(oid) + sizeof(std::int16_t);
     using input_buffer = std::span<char>;
 
-    static Update<Binary, StreamingEnabledValue::OFF> fromBuffer(
-        const input_buffer &buffer) {
+    static Update<Binary, StreamingEnabledValue::OFF, Storage> fromBuffer(
+        const input_buffer &buffer,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+        const TupleProjection *projection = nullptr) {
         const auto &oid = ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
             buffer.subspan<0, 4>());
-        const auto &[oldDataOrPrimaryKey, readBytes] =
-            parseOldDataOrPrimaryKey<Binary>(buffer.subspan<4>());
+        auto [oldDataOrPrimaryKey, readBytes] =
+            parseOldDataOrPrimaryKey<Binary, Storage>(buffer.subspan<4>(),
+                                                      resource, projection);
         return { .oid = oid,
-                 .oldDataOrPrimaryKey = oldDataOrPrimaryKey,
-                 .data = parseTupleData<Binary>(
-                             buffer.subspan(4 + sizeof('N') + readBytes))
+                 .oldDataOrPrimaryKey = std::move(oldDataOrPrimaryKey),
+                 .data = parseStoredTupleData<Binary, Storage>(
+                             buffer.subspan(4 + sizeof('N') + readBytes),
+                             resource, projection)
                              .first };
     };
+
+    Update<Binary, StreamingEnabledValue::OFF> materialize() const {
+        return { .oid = oid,
+                 .oldDataOrPrimaryKey =
+                     materializeOldDataOrPrimaryKey<Binary, Storage>(
+                         oldDataOrPrimaryKey),
+                 .data = events::materialize<Binary>(data) };
+    };
 };
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
 
 namespace std {
-template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary>
+template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary,
+          PGREPLICATION_NAMESPACE::pgoutput::TupleStorageValue Storage>
 struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Update<
-    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON>> {
+    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON,
+    Storage>> {
     template <typename ParseContext>
     constexpr auto parse(ParseContext &ctx) {
         return ctx.begin();
@@ -81,8 +113,8 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Update<
     auto format(
         const PGREPLICATION_NAMESPACE::pgoutput::events::Update<
             Binary,
-            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON>
-            &record,
+            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::ON,
+            Storage> &record,
         FormatContext &ctx) const {
         return format_to(ctx.out(),
                          "Update(transactionId: {}, oid: {}, "
@@ -92,9 +124,11 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Update<
     }
 };
 
-template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary>
+template <PGREPLICATION_NAMESPACE::pgoutput::BinaryValue Binary,
+          PGREPLICATION_NAMESPACE::pgoutput::TupleStorageValue Storage>
 struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Update<
-    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF>> {
+    Binary, PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF,
+    Storage>> {
     template <typename ParseContext>
     constexpr auto parse(ParseContext &ctx) {
         return ctx.begin();
@@ -104,8 +138,8 @@ struct formatter<PGREPLICATION_NAMESPACE::pgoutput::events::Update<
     auto format(
         const PGREPLICATION_NAMESPACE::pgoutput::events::Update<
             Binary,
-            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF>
-            &record,
+            PGREPLICATION_NAMESPACE::pgoutput::StreamingEnabledValue::OFF,
+            Storage> &record,
         FormatContext &ctx) const {
         return format_to(ctx.out(),
                          "Update(oid: {}, oldDataOrPrimaryKey: {}, data: {})",
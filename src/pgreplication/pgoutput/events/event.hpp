@@ -1,12 +1,15 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <expected>
 #include <format>
+#include <memory_resource>
 #include <optional>
 #include <span>
 #include <string>
 #include <type_traits>
+#include <utility>
 
 #include "../options.hpp"
 #include "./base/begin.hpp"
@@ -24,11 +27,14 @@
 #include "./stream_and_twophase.hpp"
 #include "./twophase.hpp"
 #include "./utils.hpp"
+#include "./validation.hpp"
+#include "pgreplication/error.hpp"
 #include "pgreplication/utils.hpp"
 
 namespace PGREPLICATION_NAMESPACE::pgoutput::events {
 template <BinaryValue Binary, MessagesValue Messages, StreamingValue Streaming,
-          TwoPhaseValue TwoPhase, OriginValue OriginConf>
+          TwoPhaseValue TwoPhase, OriginValue OriginConf,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
 struct EventStruct {
     constexpr static auto StreamingEnabled =
         streamingValueToStreamingEnabledValue(Streaming);
@@ -38,8 +44,9 @@ struct EventStruct {
                            Message<StreamingEnabled>, void>,
         Commit, std::conditional_t<OriginConf == OriginValue::ANY, Origin, void>,
         Relation<StreamingEnabled>, Type<StreamingEnabled>,
-        Insert<Binary, StreamingEnabled>, Update<Binary, StreamingEnabled>,
-        Delete<Binary, StreamingEnabled>, Truncate<StreamingEnabled>,
+        Insert<Binary, StreamingEnabled, Storage>,
+        Update<Binary, StreamingEnabled, Storage>,
+        Delete<Binary, StreamingEnabled, Storage>, Truncate<StreamingEnabled>,
         std::conditional_t<StreamingEnabled == StreamingEnabledValue::ON,
                            StreamStart, void>,
         std::conditional_t<StreamingEnabled == StreamingEnabledValue::ON,
@@ -59,138 +66,156 @@ struct EventStruct {
 };
 
 template <BinaryValue Binary, MessagesValue Messages, StreamingValue Streaming,
-          TwoPhaseValue TwoPhase, OriginValue OriginConf>
-using Event =
-    EventStruct<Binary, Messages, Streaming, TwoPhase, OriginConf>::Event;
+          TwoPhaseValue TwoPhase, OriginValue OriginConf,
+          TupleStorageValue Storage = TupleStorageValue::OWNED>
+using Event = EventStruct<Binary, Messages, Streaming, TwoPhase, OriginConf,
+                          Storage>::Event;
 
-template <MessagesValue Messages, StreamingEnabledValue StreamingEnabled,
-          TwoPhaseValue TwoPhase, OriginValue OriginConf>
-using EventType = ::PGREPLICATION_NAMESPACE::utils::make_variant_t<
-    BaseEventType,
-    std::conditional_t<Messages == MessagesValue::ON, MessagesEventType, void>,
-    std::conditional_t<OriginConf == OriginValue::ANY, OriginEventType, void>,
-    std::conditional_t<StreamingEnabled == StreamingEnabledValue::ON,
-                       StreamingEventType, void>,
-    std::conditional_t<TwoPhase == TwoPhaseValue::ON, TwoPhaseCommitEventType,
-                       void>,
-    std::conditional_t<StreamingEnabled == StreamingEnabledValue::ON &&
-                           TwoPhase == TwoPhaseValue::ON,
-                       StreamingAndTwoPhaseCommitEventType, void>>;
-
-template <MessagesValue Messages, StreamingEnabledValue StreamingEnabled,
-          TwoPhaseValue TwoPhase, OriginValue OriginConf>
-std::optional<EventType<Messages, StreamingEnabled, TwoPhase, OriginConf>>
-parseEventType(const char &c) {
-    const auto &baseEventType = parseBaseEvenType(c);
-    if (baseEventType.has_value()) return baseEventType.value();
-    if constexpr (Messages == MessagesValue::ON) {
-        if (static_cast<MessagesEventType>(c) == MessagesEventType::MESSAGE)
-            return MessagesEventType::MESSAGE;
-    };
-    if constexpr (OriginConf == OriginValue::ANY) {
-        if (static_cast<OriginEventType>(c) == OriginEventType::ORIGIN) {
-            return OriginEventType::ORIGIN;
-        };
-    };
-    if constexpr (StreamingEnabled == StreamingEnabledValue::ON) {
-        const auto &streamingEventType = parseStreamingEventType(c);
-        if (streamingEventType.has_value()) return streamingEventType.value();
-    };
-    if constexpr (TwoPhase == TwoPhaseValue::ON) {
-        const auto &twoPhaseCommitEventType = parseTwoPhaseCommitEventType(c);
-        if (twoPhaseCommitEventType.has_value())
-            return twoPhaseCommitEventType.value();
+template <typename EventVariant, typename T, ValidationValue Validation>
+std::expected<EventVariant, ParseError> parseEventAs(
+    const std::span<char> &buffer, std::pmr::memory_resource *resource) {
+    if constexpr (std::is_empty_v<T>) {
+        return EventVariant(std::in_place_type<T>);
+    } else if constexpr (Validation == ValidationValue::TRUSTED) {
+        return EventVariant(std::in_place_type<T>,
+                            utils::parseTrustedEvent<T>(buffer, resource));
+    } else {
+        const auto &valid = validation::validateEventBuffer<T>(buffer);
+        if (!valid.has_value()) return std::unexpected(valid.error());
+        auto result = [&]() {
+            if constexpr (utils::StaticSizeEvent<T>) {
+                return utils::parseStaticSizeEvent<T>(buffer);
+            } else {
+                return utils::parseDynamicSizeEvent<T>(buffer, resource);
+            };
+        }();
+        if (!result.has_value()) return std::unexpected(result.error());
+        return EventVariant(std::in_place_type<T>, std::move(result.value()));
     };
+};
 
-    if constexpr (StreamingEnabled == StreamingEnabledValue::ON &&
-                  TwoPhase == TwoPhaseValue::ON) {
-        if (static_cast<StreamingAndTwoPhaseCommitEventType>(c) ==
-            StreamingAndTwoPhaseCommitEventType::STREAM_PREPARE)
-            return StreamingAndTwoPhaseCommitEventType::STREAM_PREPARE;
-    };
-    return std::nullopt;
+template <typename EventVariant>
+using EventParser = std::expected<EventVariant, ParseError> (*)(
+    const std::span<char> &, std::pmr::memory_resource *);
+
+template <typename EventVariant, ValidationValue Validation, typename T,
+          typename EventTypeValue>
+constexpr void addEventParser(std::array<EventParser<EventVariant>, 256> &table,
+                              const EventTypeValue &eventType) {
+    table[static_cast<unsigned char>(eventType)] =
+        &parseEventAs<EventVariant, T, Validation>;
 };
 
+// Maps the leading message byte straight to the parser of the event type
+// enabled for the session, so parseEvent needs a single indirect call instead
+// of resolving an EventType variant first. HARDENED parsers validate the
+// whole message before decoding it, TRUSTED ones decode it unchecked.
 template <BinaryValue Binary, MessagesValue Messages, StreamingValue Streaming,
-          TwoPhaseValue TwoPhase, OriginValue OriginConf>
-std::expected<Event<Binary, Messages, Streaming, TwoPhase, OriginConf>,
-              std::string>
-parseEventByType(
-    const EventType<Messages, streamingValueToStreamingEnabledValue(Streaming),
-                    TwoPhase, OriginConf> &eventType,
-    const std::span<char> &buffer) {
+          TwoPhaseValue TwoPhase, OriginValue OriginConf,
+          TupleStorageValue Storage, ValidationValue Validation>
+constexpr std::array<
+    EventParser<Event<Binary, Messages, Streaming, TwoPhase, OriginConf,
+                      Storage>>,
+    256>
+makeEventDispatchTable() {
     constexpr auto StreamingEnabled =
         streamingValueToStreamingEnabledValue(Streaming);
-    if (std::holds_alternative<BaseEventType>(eventType)) {
-        const auto &baseEventType = std::get<BaseEventType>(eventType);
-        return parseBaseEvent<Binary, StreamingEnabled>(baseEventType, buffer)
-            .transform([](const auto &event) {
-                return std::visit(
-                    [](auto &&arg) -> Event<Binary, Messages, Streaming,
-                                            TwoPhase, OriginConf> {
-                        return arg;
-                    },
-                    event);
-            });
-    };
+    using EventVariant =
+        Event<Binary, Messages, Streaming, TwoPhase, OriginConf, Storage>;
+    std::array<EventParser<EventVariant>, 256> table{};
+    addEventParser<EventVariant, Validation, Begin>(table,
+                                                    BaseEventType::BEGIN);
+    addEventParser<EventVariant, Validation, Commit>(table,
+                                                     BaseEventType::COMMIT);
+    addEventParser<EventVariant, Validation, Relation<StreamingEnabled>>(
+        table, BaseEventType::RELATION);
+    addEventParser<EventVariant, Validation, Type<StreamingEnabled>>(
+        table, BaseEventType::TYPE);
+    addEventParser<EventVariant, Validation,
+                   Insert<Binary, StreamingEnabled, Storage>>(
+        table, BaseEventType::INSERT);
+    addEventParser<EventVariant, Validation,
+                   Update<Binary, StreamingEnabled, Storage>>(
+        table, BaseEventType::UPDATE);
+    addEventParser<EventVariant, Validation,
+                   Delete<Binary, StreamingEnabled, Storage>>(
+        table, BaseEventType::DELETE);
+    addEventParser<EventVariant, Validation, Truncate<StreamingEnabled>>(
+        table, BaseEventType::TRUNCATE);
     if constexpr (Messages == MessagesValue::ON) {
-        if (std::holds_alternative<MessagesEventType>(eventType)) {
-            return Message<StreamingEnabled>::fromBuffer(buffer);
-        };
+        addEventParser<EventVariant, Validation, Message<StreamingEnabled>>(
+            table, MessagesEventType::MESSAGE);
     };
     if constexpr (OriginConf == OriginValue::ANY) {
-        if (std::holds_alternative<OriginEventType>(eventType)) {
-            return Origin::fromBuffer(buffer);
-        };
+        addEventParser<EventVariant, Validation, Origin>(
+            table, OriginEventType::ORIGIN);
     };
-    if constexpr (Streaming != StreamingValue::OFF) {
-        if (std::holds_alternative<StreamingEventType>(eventType)) {
-            const auto &streamingEventType =
-                std::get<StreamingEventType>(eventType);
-            return parseStreamingEvent<Streaming>(streamingEventType, buffer)
-                .transform([](const auto &event) {
-                    return std::visit(
-                        [](auto &&arg) -> Event<Binary, Messages, Streaming,
-                                                TwoPhase, OriginConf> {
-                            return arg;
-                        },
-                        event);
-                });
-        };
+    if constexpr (StreamingEnabled == StreamingEnabledValue::ON) {
+        addEventParser<EventVariant, Validation, StreamStart>(
+            table, StreamingEventType::STREAM_START);
+        addEventParser<EventVariant, Validation, StreamStop>(
+            table, StreamingEventType::STREAM_STOP);
+        addEventParser<EventVariant, Validation, StreamCommit>(
+            table, StreamingEventType::STREAM_COMMIT);
+        addEventParser<EventVariant, Validation, StreamAbort<Streaming>>(
+            table, StreamingEventType::STREAM_ABORT);
     };
     if constexpr (TwoPhase == TwoPhaseValue::ON) {
-        if (std::holds_alternative<TwoPhaseCommitEventType>(eventType)) {
-            const auto &twoPhaseCommitEventType =
-                std::get<TwoPhaseCommitEventType>(eventType);
-            return parseTwoPhaseCommitEvent(eventType, buffer);
-        };
+        addEventParser<EventVariant, Validation, BeginPrepare>(
+            table, TwoPhaseCommitEventType::BEGIN_PREPARE);
+        addEventParser<EventVariant, Validation, Prepare>(
+            table, TwoPhaseCommitEventType::PREPARE);
+        addEventParser<EventVariant, Validation, CommitPrepared>(
+            table, TwoPhaseCommitEventType::COMMIT_PREPARED);
+        addEventParser<EventVariant, Validation, RollbackPrepared>(
+            table, TwoPhaseCommitEventType::ROLLBACK_PREPARED);
     };
-    if constexpr (TwoPhase == TwoPhaseValue::ON &&
-                  Streaming != StreamingValue::OFF) {
-        if (std::holds_alternative<StreamingAndTwoPhaseCommitEventType>(
-                eventType)) {
-            return utils::parseDynamicSizeEvent<StreamPrepare>(buffer);
-        };
+    if constexpr (StreamingEnabled == StreamingEnabledValue::ON &&
+                  TwoPhase == TwoPhaseValue::ON) {
+        addEventParser<EventVariant, Validation, StreamPrepare>(
+            table, StreamingAndTwoPhaseCommitEventType::STREAM_PREPARE);
     };
-    return std::unexpected("No event type was matched");
+    return table;
 };
 
 template <BinaryValue Binary, MessagesValue Messages, StreamingValue Streaming,
-          TwoPhaseValue TwoPhase, OriginValue OriginConf>
-std::expected<Event<Binary, Messages, Streaming, TwoPhase, OriginConf>,
-              std::string>
-parseEvent(const std::span<char> &buffer) {
+          TwoPhaseValue TwoPhase, OriginValue OriginConf,
+          TupleStorageValue Storage, ValidationValue Validation>
+inline constexpr auto eventDispatchTable =
+    makeEventDispatchTable<Binary, Messages, Streaming, TwoPhase, OriginConf,
+                           Storage, Validation>();
+
+template <BinaryValue Binary, MessagesValue Messages, StreamingValue Streaming,
+          TwoPhaseValue TwoPhase, OriginValue OriginConf,
+          TupleStorageValue Storage = TupleStorageValue::OWNED,
+          ValidationValue Validation = ValidationValue::HARDENED>
+std::expected<
+    Event<Binary, Messages, Streaming, TwoPhase, OriginConf, Storage>,
+    ParseError>
+parseEvent(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    if constexpr (Validation == ValidationValue::HARDENED) {
+        if (buffer.empty()) {
+            return std::unexpected(
+                ParseError{ .code = ParseErrorCode::EMPTY_MESSAGE });
+        };
+    };
     assert(buffer.size() > 0);
-    const auto &eventTypeOptional =
-        parseEventType<Messages,
-                       streamingValueToStreamingEnabledValue(Streaming),
-                       TwoPhase, OriginConf>(buffer[0]);
-    if (!eventTypeOptional.has_value()) {
-        return std::unexpected(std::format("Unexpected type: '{}'", buffer[0]));
+    const auto &parser =
+        eventDispatchTable<Binary, Messages, Streaming, TwoPhase, OriginConf,
+                           Storage,
+                           Validation>[static_cast<unsigned char>(buffer[0])];
+    if (parser == nullptr) {
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::UNEXPECTED_TYPE, .eventType = buffer[0] });
+    };
+    auto result = parser(buffer.subspan(1), resource);
+    if (!result.has_value()) {
+        result.error().eventType = buffer[0];
+        result.error().offset += 1;
     };
-    const auto &eventType = eventTypeOptional.value();
-    return parseEventByType<Binary, Messages, Streaming, TwoPhase, OriginConf>(
-        eventType, buffer.subspan(1));
+    return result;
 };
 
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
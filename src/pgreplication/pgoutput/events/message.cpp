@@ -15,7 +15,7 @@ Message<StreamingEnabledValue::ON>::fromBuffer(const input_buffer &buffer) {
     const auto &flags =
         static_cast<std::int8_t>(buffer.subspan<4, 1>().front());
     const auto &lsn = utils::int64FromNetwork(buffer.subspan<5, 8>());
-    const auto &prefix = std::string(buffer.subspan<13>().data());
+    auto prefix = std::string(buffer.subspan<13>().data());
     const auto &contentLength = utils::int32FromNetwork(
         buffer.subspan(13 + 1 + prefix.size(), 4).subspan<0, 4>());
     const auto &contentBuffer =
@@ -27,8 +27,8 @@ Message<StreamingEnabledValue::ON>::fromBuffer(const input_buffer &buffer) {
         .transactionId = transactionId,
         .flags = flags,
         .lsn = lsn,
-        .prefix = prefix,
-        .content = content,
+        .prefix = std::move(prefix),
+        .content = std::move(content),
     };
 };
 
@@ -37,7 +37,7 @@ Message<StreamingEnabledValue::OFF>::fromBuffer(const input_buffer &buffer) {
     const auto &flags =
         static_cast<std::int8_t>(buffer.subspan<0, 1>().front());
     const auto &lsn = utils::int64FromNetwork(buffer.subspan<1, 8>());
-    const auto &prefix = std::string(buffer.subspan<9>().data());
+    auto prefix = std::string(buffer.subspan<9>().data());
     const auto &contentLength = utils::int32FromNetwork(
         buffer.subspan(9 + 1 + prefix.size(), 4).subspan<0, 4>());
     const auto &contentBuffer =
@@ -48,8 +48,8 @@ Message<StreamingEnabledValue::OFF>::fromBuffer(const input_buffer &buffer) {
     return {
         .flags = flags,
         .lsn = lsn,
-        .prefix = prefix,
-        .content = content,
+        .prefix = std::move(prefix),
+        .content = std::move(content),
     };
 };
 
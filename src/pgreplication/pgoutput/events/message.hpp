@@ -25,7 +25,7 @@ struct Message<StreamingEnabledValue::ON> {
     std::vector<std::byte> content;
 
     constexpr static const std::size_t minBufferSize =
-        sizeof(transactionId) + sizeof(flags) + sizeof(lsn) + sizeof(prefix) +
+        sizeof(transactionId) + sizeof(flags) + sizeof(lsn) + 1 +
         sizeof(std::int32_t);
     using input_buffer = std::span<char>;
 
@@ -41,7 +41,7 @@ struct Message<StreamingEnabledValue::OFF> {
     std::vector<std::byte> content;
 
     constexpr static const std::size_t minBufferSize =
-        sizeof(flags) + sizeof(lsn) + sizeof(prefix) + sizeof(std::int32_t);
+        sizeof(flags) + sizeof(lsn) + 1 + sizeof(std::int32_t);
 
     using input_buffer = std::span<char>;
 
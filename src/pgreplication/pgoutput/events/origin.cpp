@@ -1,4 +1,6 @@
 #include "./origin.hpp"
+
+#include <cstring>
 #include <string>
 
 #include "pgreplication/utils.hpp"
@@ -7,6 +9,7 @@ namespace PGREPLICATION_NAMESPACE::pgoutput::events {
 Origin Origin::fromBuffer(const input_buffer &buffer) {
     const auto &origin = buffer.subspan<8>();
     return { .commitLsn = utils::int64FromNetwork(buffer.subspan<0, 8>()),
-             .origin = std::string(origin.data(), origin.size()) };
+             .origin = std::string(origin.data(),
+                                   strnlen(origin.data(), origin.size())) };
 };
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
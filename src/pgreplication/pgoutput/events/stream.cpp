@@ -1,26 +1,12 @@
 #include "./stream.hpp"
 
 #include <cstdint>
-#include <optional>
 
 #include "pgreplication/pgoutput/options.hpp"
 #include "pgreplication/utils.hpp"
 
 using namespace PGREPLICATION_NAMESPACE::utils;
 namespace PGREPLICATION_NAMESPACE::pgoutput::events {
-std::optional<StreamingEventType> parseStreamingEventType(const char &c) {
-    const auto &casted = static_cast<StreamingEventType>(c);
-    switch (casted) {
-        case StreamingEventType::STREAM_START:
-        case StreamingEventType::STREAM_STOP:
-        case StreamingEventType::STREAM_COMMIT:
-        case StreamingEventType::STREAM_ABORT:
-            return casted;
-        default:
-            return std::nullopt;
-    };
-};
-
 StreamStart StreamStart::fromBuffer(const input_buffer &buffer) {
     return {
         .transactionId = int32FromNetwork(buffer.subspan<0, 4>()),
@@ -2,12 +2,9 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <expected>
 #include <format>
-#include <optional>
 #include <span>
 #include <string>
-#include <variant>
 
 #include "../options.hpp"
 #include "./utils.hpp"
@@ -21,8 +18,6 @@ enum class StreamingEventType {
     STREAM_ABORT = 'A',
 };
 
-std::optional<StreamingEventType> parseStreamingEventType(const char &c);
-
 struct StreamStart {
     std::int32_t transactionId;
     std::int8_t flags;
@@ -83,24 +78,6 @@ struct StreamAbort<StreamingValue::ON> {
         const input_buffer &buffer);
 };
 
-template <StreamingValue Streaming>
-std::expected<
-    std::variant<StreamStart, StreamStop, StreamCommit, StreamAbort<Streaming>>,
-    std::string>
-parseStreamingEvent(const StreamingEventType &eventType,
-                    const std::span<char> &buffer) {
-    switch (eventType) {
-        case StreamingEventType::STREAM_START:
-            return utils::parseStaticSizeEvent<StreamStart>(buffer);
-        case StreamingEventType::STREAM_STOP:
-            return StreamStop{};
-        case StreamingEventType::STREAM_COMMIT:
-            return utils::parseStaticSizeEvent<StreamCommit>(buffer);
-        case StreamingEventType::STREAM_ABORT:
-            return utils::parseStaticSizeEvent<StreamAbort<Streaming>>(buffer);
-    };
-};
-
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
 
 namespace std {
@@ -2,12 +2,9 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <expected>
 #include <format>
-#include <optional>
 #include <span>
 #include <string>
-#include <variant>
 
 namespace PGREPLICATION_NAMESPACE::pgoutput::events {
 enum class TwoPhaseCommitEventType {
@@ -17,9 +14,6 @@ enum class TwoPhaseCommitEventType {
     ROLLBACK_PREPARED = 'r',
 };
 
-std::optional<TwoPhaseCommitEventType> parseTwoPhaseCommitEventType(
-    const char &c);
-
 struct BeginPrepare {
     std::int64_t lsn;
     std::int64_t endLsn;
@@ -85,11 +79,6 @@ struct RollbackPrepared {
     static RollbackPrepared fromBuffer(const input_buffer &buffer);
 };
 
-std::expected<
-    std::variant<BeginPrepare, Prepare, CommitPrepared, RollbackPrepared>,
-    std::string>
-parseTwoPhaseCommitEvent(const TwoPhaseCommitEventType &eventType,
-                         const std::span<char> &buffer);
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events
 
 namespace std {
@@ -2,11 +2,13 @@
 
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <expected>
-#include <format>
 #include <functional>
+#include <memory_resource>
 #include <span>
-#include <string>
+
+#include "pgreplication/error.hpp"
 
 namespace PGREPLICATION_NAMESPACE::pgoutput::events::utils {
 template <typename T>
@@ -19,33 +21,55 @@ concept StaticSizeEvent = requires(T a) {
 };
 
 template <StaticSizeEvent T>
-std::expected<T, std::string> parseStaticSizeEvent(
+std::expected<T, ParseError> parseStaticSizeEvent(
     const std::span<char> &buffer) {
     if (buffer.size() != T::bufferSize) {
-        return std::unexpected(std::format("{} event buffer size must be {}",
-                                           typeid(T).name(), T::bufferSize));
+        return std::unexpected(
+            ParseError{ .code = ParseErrorCode::BUFFER_SIZE_MISMATCH,
+                        .expectedSize = T::bufferSize,
+                        .receivedSize =
+                            static_cast<std::uint32_t>(buffer.size()) });
     };
     return T::fromBuffer(buffer.subspan<0, T::bufferSize>());
 };
 
 template <typename T>
-concept DynamicSizeEvent = requires(T a) {
+concept DynamicSizeEvent = requires(const typename T::input_buffer &buffer) {
     { T::minBufferSize } -> std::convertible_to<std::size_t>;
-    {
-        T::fromBuffer
-    }
-    -> std::convertible_to<std::function<T(const typename T::input_buffer &)>>;
+    { T::fromBuffer(buffer) } -> std::same_as<T>;
 };
 
 template <DynamicSizeEvent T>
-std::expected<T, std::string> parseDynamicSizeEvent(
-    const std::span<char> &buffer) {
+std::expected<T, ParseError> parseDynamicSizeEvent(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
     if (buffer.size() < T::minBufferSize) {
         return std::unexpected(
-            std::format("{} event buffer size must be gte {}", typeid(T).name(),
-                        T::minBufferSize));
+            ParseError{ .code = ParseErrorCode::BUFFER_TOO_SMALL,
+                        .expectedSize = T::minBufferSize,
+                        .receivedSize =
+                            static_cast<std::uint32_t>(buffer.size()) });
+    };
+    if constexpr (requires { T::fromBuffer(buffer.subspan<0>(), resource); }) {
+        return T::fromBuffer(buffer.subspan<0>(), resource);
+    } else {
+        return T::fromBuffer(buffer.subspan<0>());
+    };
+};
+
+// Decodes buffer without checking its size; only for messages that are known
+// to be well formed, such as a direct walsender feed.
+template <typename T>
+T parseTrustedEvent(
+    const std::span<char> &buffer,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+    if constexpr (StaticSizeEvent<T>) {
+        return T::fromBuffer(buffer.first<T::bufferSize>());
+    } else if constexpr (requires { T::fromBuffer(buffer, resource); }) {
+        return T::fromBuffer(buffer, resource);
+    } else {
+        return T::fromBuffer(buffer);
     };
-    return T::fromBuffer(buffer.subspan<0>());
 };
 
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput::events::utils
@@ -0,0 +1,40 @@
+#include "./validation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include "pgreplication/error.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput::events::validation {
+bool WireCursor::outOfBounds(std::size_t size) {
+    if (failure.has_value()) return false;
+    failure = ParseError{
+        .code = ParseErrorCode::BUFFER_TOO_SMALL,
+        .offset = static_cast<std::uint32_t>(position),
+        .expectedSize = static_cast<std::uint32_t>(position + size),
+        .receivedSize = static_cast<std::uint32_t>(buffer.size()) };
+    return false;
+};
+
+bool WireCursor::fail(ParseErrorCode code, std::uint32_t receivedSize) {
+    if (failure.has_value()) return false;
+    failure = ParseError{ .code = code,
+                          .offset = static_cast<std::uint32_t>(position),
+                          .receivedSize = receivedSize };
+    return false;
+};
+
+bool WireCursor::cString() {
+    if (failure.has_value()) return false;
+    const auto *begin = buffer.data() + position;
+    const auto *terminator =
+        std::memchr(begin, '\0', buffer.size() - position);
+    if (terminator == nullptr) {
+        return fail(ParseErrorCode::UNTERMINATED_STRING);
+    };
+    position += static_cast<const char *>(terminator) - begin + 1;
+    return true;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput::events::validation
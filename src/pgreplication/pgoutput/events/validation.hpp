@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+
+#include "./base/delete.hpp"
+#include "./base/insert.hpp"
+#include "./base/relation.hpp"
+#include "./base/truncate.hpp"
+#include "./base/type.hpp"
+#include "./base/update.hpp"
+#include "./message.hpp"
+#include "./utils.hpp"
+#include "pgreplication/error.hpp"
+#include "pgreplication/pgoutput/options.hpp"
+#include "pgreplication/utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput::events::validation {
+// Reads through a message without decoding it. Every read is bounds checked
+// and the first failure is kept in error(); later reads fail immediately,
+// so validators only need to test the result of each step.
+class WireCursor {
+   public:
+    explicit WireCursor(std::span<char> buffer) : buffer(buffer) {};
+
+    bool skip(std::size_t size) {
+        if (!require(size)) return false;
+        position += size;
+        return true;
+    };
+
+    std::optional<char> byte() {
+        if (!require(1)) return std::nullopt;
+        return buffer[position++];
+    };
+
+    std::optional<char> peek() const {
+        if (failure.has_value() || position == buffer.size()) {
+            return std::nullopt;
+        };
+        return buffer[position];
+    };
+
+    std::optional<std::int16_t> int16() {
+        if (!require(sizeof(std::int16_t))) return std::nullopt;
+        const auto &value = ::PGREPLICATION_NAMESPACE::utils::int16FromNetwork(
+            buffer.subspan(position).first<sizeof(std::int16_t)>());
+        position += sizeof(std::int16_t);
+        return value;
+    };
+
+    std::optional<std::int32_t> int32() {
+        if (!require(sizeof(std::int32_t))) return std::nullopt;
+        const auto &value = ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
+            buffer.subspan(position).first<sizeof(std::int32_t)>());
+        position += sizeof(std::int32_t);
+        return value;
+    };
+
+    // Unchecked access for callers that check bounds themselves.
+    std::span<char> remaining() const { return buffer.subspan(position); };
+    void advance(std::size_t size) { position += size; };
+
+    bool cString();
+    bool fail(ParseErrorCode code, std::uint32_t receivedSize = 0);
+
+    bool atEnd() const { return position == buffer.size(); };
+    const std::optional<ParseError> &error() const { return failure; };
+
+   private:
+    bool require(std::size_t size) {
+        if (!failure.has_value() && buffer.size() - position >= size) {
+            return true;
+        };
+        return outOfBounds(size);
+    };
+    bool outOfBounds(std::size_t size);
+
+    std::span<char> buffer;
+    std::size_t position = 0;
+    std::optional<ParseError> failure;
+};
+
+// The per column loop is the hot part of validation, so it reads the
+// remaining bytes directly and only goes through the checked reads to
+// report a failure.
+template <BinaryValue Binary>
+bool tupleData(WireCursor &cursor) {
+    const auto &count = cursor.int16();
+    if (!count.has_value()) return false;
+    if (count.value() < 0) {
+        return cursor.fail(ParseErrorCode::INVALID_LENGTH,
+                           static_cast<std::uint32_t>(count.value()));
+    };
+    constexpr auto valueKind = Binary == BinaryValue::ON ? 'b' : 't';
+    constexpr std::size_t headerSize = 1 + sizeof(std::int32_t);
+    for (std::int16_t index = 0; index < count.value(); index++) {
+        const auto &rest = cursor.remaining();
+        if (rest.empty()) return cursor.skip(1);
+        if (rest[0] == 'n' || rest[0] == 'u') {
+            cursor.advance(1);
+            continue;
+        };
+        if (rest[0] != valueKind) {
+            return cursor.fail(ParseErrorCode::INVALID_VALUE);
+        };
+        if (rest.size() < headerSize) return cursor.skip(headerSize);
+        const auto &size = ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
+            rest.subspan<1, sizeof(std::int32_t)>());
+        if (size < 0) {
+            return cursor.fail(ParseErrorCode::INVALID_LENGTH,
+                               static_cast<std::uint32_t>(size));
+        };
+        const auto &columnSize = headerSize + static_cast<std::size_t>(size);
+        if (rest.size() < columnSize) return cursor.skip(columnSize);
+        cursor.advance(columnSize);
+    };
+    return true;
+};
+
+template <StreamingEnabledValue Streaming>
+constexpr std::size_t transactionIdSize =
+    Streaming == StreamingEnabledValue::ON ? sizeof(std::int32_t) : 0;
+
+// Walks the wire format of T. The generic case covers the static size
+// events, and the dynamic ones whose only variable part is a trailing
+// string (origin name, two-phase gid).
+template <typename T>
+struct EventValidator {
+    static bool validate(WireCursor &cursor) {
+        if constexpr (utils::StaticSizeEvent<T>) {
+            return cursor.skip(T::bufferSize);
+        } else {
+            return cursor.skip(T::minBufferSize - 1) && cursor.cString();
+        };
+    };
+};
+
+template <StreamingEnabledValue Streaming>
+struct EventValidator<Message<Streaming>> {
+    static bool validate(WireCursor &cursor) {
+        if (!cursor.skip(transactionIdSize<Streaming> + sizeof(std::int8_t) +
+                         sizeof(std::int64_t)) ||
+            !cursor.cString()) {
+            return false;
+        };
+        const auto &size = cursor.int32();
+        if (!size.has_value()) return false;
+        if (size.value() < 0) {
+            return cursor.fail(ParseErrorCode::INVALID_LENGTH,
+                               static_cast<std::uint32_t>(size.value()));
+        };
+        return cursor.skip(static_cast<std::size_t>(size.value()));
+    };
+};
+
+template <StreamingEnabledValue Streaming>
+struct EventValidator<Relation<Streaming>> {
+    static bool validate(WireCursor &cursor) {
+        if (!cursor.skip(transactionIdSize<Streaming> + sizeof(std::int32_t)) ||
+            !cursor.cString() || !cursor.cString() ||
+            !cursor.skip(sizeof(std::int8_t))) {
+            return false;
+        };
+        const auto &count = cursor.int16();
+        if (!count.has_value()) return false;
+        if (count.value() < 0) {
+            return cursor.fail(ParseErrorCode::INVALID_LENGTH,
+                               static_cast<std::uint32_t>(count.value()));
+        };
+        for (std::int16_t index = 0; index < count.value(); index++) {
+            if (!cursor.skip(sizeof(std::int8_t)) || !cursor.cString() ||
+                !cursor.skip(2 * sizeof(std::int32_t))) {
+                return false;
+            };
+        };
+        return true;
+    };
+};
+
+template <StreamingEnabledValue Streaming>
+struct EventValidator<Type<Streaming>> {
+    static bool validate(WireCursor &cursor) {
+        return cursor.skip(transactionIdSize<Streaming> +
+                           sizeof(std::int32_t)) &&
+               cursor.cString() && cursor.cString();
+    };
+};
+
+template <StreamingEnabledValue Streaming>
+struct EventValidator<Truncate<Streaming>> {
+    static bool validate(WireCursor &cursor) {
+        if (!cursor.skip(transactionIdSize<Streaming>)) return false;
+        const auto &count = cursor.int32();
+        if (!count.has_value()) return false;
+        if (count.value() < 0) {
+            return cursor.fail(ParseErrorCode::INVALID_LENGTH,
+                               static_cast<std::uint32_t>(count.value()));
+        };
+        return cursor.skip(sizeof(std::int8_t)) &&
+               cursor.skip(static_cast<std::size_t>(count.value()) *
+                           sizeof(std::int32_t));
+    };
+};
+
+template <BinaryValue Binary, StreamingEnabledValue Streaming,
+          TupleStorageValue Storage>
+struct EventValidator<Insert<Binary, Streaming, Storage>> {
+    static bool validate(WireCursor &cursor) {
+        if (!cursor.skip(transactionIdSize<Streaming> + sizeof(std::int32_t)))
+            return false;
+        const auto &marker = cursor.byte();
+        if (!marker.has_value()) return false;
+        if (marker.value() != 'N') {
+            return cursor.fail(ParseErrorCode::INVALID_VALUE);
+        };
+        return tupleData<Binary>(cursor);
+    };
+};
+
+template <BinaryValue Binary, StreamingEnabledValue Streaming,
+          TupleStorageValue Storage>
+struct EventValidator<Update<Binary, Streaming, Storage>> {
+    static bool validate(WireCursor &cursor) {
+        if (!cursor.skip(transactionIdSize<Streaming> + sizeof(std::int32_t)))
+            return false;
+        const auto &old = cursor.peek();
+        if (old == 'K' || old == 'O') {
+            if (!cursor.skip(1) || !tupleData<Binary>(cursor)) return false;
+        };
+        const auto &marker = cursor.byte();
+        if (!marker.has_value()) return false;
+        if (marker.value() != 'N') {
+            return cursor.fail(ParseErrorCode::INVALID_VALUE);
+        };
+        return tupleData<Binary>(cursor);
+    };
+};
+
+template <BinaryValue Binary, StreamingEnabledValue Streaming,
+          TupleStorageValue Storage>
+struct EventValidator<Delete<Binary, Streaming, Storage>> {
+    static bool validate(WireCursor &cursor) {
+        if (!cursor.skip(transactionIdSize<Streaming> + sizeof(std::int32_t)))
+            return false;
+        if (cursor.atEnd()) return true;
+        const auto &marker = cursor.byte();
+        if (marker != 'K' && marker != 'O') {
+            return cursor.fail(ParseErrorCode::INVALID_VALUE);
+        };
+        return tupleData<Binary>(cursor);
+    };
+};
+
+// Checks that every length prefix and string of the message body (without
+// the type byte) stays inside buffer, so fromBuffer can read it without
+// further checks. Buffers shorter than the fixed part of the event fail
+// with the same error as parseStaticSizeEvent/parseDynamicSizeEvent.
+template <typename T>
+std::expected<void, ParseError> validateEventBuffer(
+    const std::span<char> &buffer) {
+    if constexpr (utils::StaticSizeEvent<T>) {
+        if (buffer.size() != T::bufferSize) {
+            return std::unexpected(
+                ParseError{ .code = ParseErrorCode::BUFFER_SIZE_MISMATCH,
+                            .expectedSize = T::bufferSize,
+                            .receivedSize =
+                                static_cast<std::uint32_t>(buffer.size()) });
+        };
+        return {};
+    } else {
+        if (buffer.size() < T::minBufferSize) {
+            return std::unexpected(
+                ParseError{ .code = ParseErrorCode::BUFFER_TOO_SMALL,
+                            .expectedSize = T::minBufferSize,
+                            .receivedSize =
+                                static_cast<std::uint32_t>(buffer.size()) });
+        };
+        WireCursor cursor(buffer);
+        if (!EventValidator<T>::validate(cursor)) {
+            return std::unexpected(cursor.error().value());
+        };
+        return {};
+    };
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput::events::validation
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#include "./batch.hpp"
+#include "pgreplication/error.hpp"
+#include "pgreplication/pgoutput/events/base/event.hpp"
+#include "pgreplication/pgoutput/events/base/tuple_data.hpp"
+#include "pgreplication/pgoutput/events/validation.hpp"
+#include "pgreplication/pgoutput/options.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+enum class FilterAction { KEEP, SKIP };
+
+// A filter hooks into the parse loop of parseFiltered at two points:
+//
+//   FilterAction beforeParse(const std::span<char> &buffer)
+//     sees the raw message (type byte and fixed header fields) and can skip
+//     it without parsing;
+//   FilterAction afterParse(Event &event)
+//     sees the parsed event, may edit it, and can still drop it.
+//
+// A filter may also provide
+//
+//   const events::TupleProjection *rowProjection(
+//       const std::span<char> &buffer) const
+//
+// to decode only some columns of an Insert/Update/Delete; the first filter
+// returning a projection wins. Filters run in order and a message skipped by
+// one of them is not shown to the filters after it.
+template <typename Filter, typename Event>
+concept EventFilter =
+    requires(Filter &filter, const std::span<char> &buffer, Event &event) {
+        { filter.beforeParse(buffer) } -> std::same_as<FilterAction>;
+        { filter.afterParse(event) } -> std::same_as<FilterAction>;
+    };
+
+// Parses an Insert/Update/Delete of type T keeping only the projected
+// columns.
+template <typename Context, typename T>
+std::expected<typename Context::Event, ParseError> parseProjectedRow(
+    const std::span<char> &buffer, std::pmr::memory_resource *resource,
+    const events::TupleProjection *projection) {
+    const auto &body = buffer.subspan(1);
+    if constexpr (Context::Validation == ValidationValue::HARDENED) {
+        const auto &valid = events::validation::validateEventBuffer<T>(body);
+        if (!valid.has_value()) {
+            auto error = valid.error();
+            error.eventType = buffer[0];
+            error.offset += 1;
+            return std::unexpected(error);
+        };
+    };
+    return typename Context::Event(std::in_place_type<T>,
+                                   T::fromBuffer(body, resource, projection));
+};
+
+// Like Context::parseEvent, decoding only the projected columns of row
+// messages when projection is not nullptr.
+template <typename Context>
+std::expected<typename Context::Event, ParseError> parseProjectedEvent(
+    const std::span<char> &buffer, std::pmr::memory_resource *resource,
+    const events::TupleProjection *projection) {
+    using Events = typename Context::events;
+    if (projection != nullptr && !buffer.empty()) {
+        using enum events::BaseEventType;
+        switch (buffer[0]) {
+            case static_cast<char>(INSERT):
+                return parseProjectedRow<Context, typename Events::Insert>(
+                    buffer, resource, projection);
+            case static_cast<char>(UPDATE):
+                return parseProjectedRow<Context, typename Events::Update>(
+                    buffer, resource, projection);
+            case static_cast<char>(DELETE):
+                return parseProjectedRow<Context, typename Events::Delete>(
+                    buffer, resource, projection);
+        };
+    };
+    return Context::parseEvent(buffer, resource);
+};
+
+// The loop shared by every filtered session: runs the beforeParse hooks,
+// parses the message with the first row projection on offer and runs the
+// afterParse hooks. Returns std::nullopt for skipped messages.
+template <typename Context, EventFilter<typename Context::Event>... Filters>
+std::expected<std::optional<typename Context::Event>, ParseError>
+parseFiltered(const std::span<char> &buffer,
+              std::pmr::memory_resource *resource, Filters &...filters) {
+    if ((... || (filters.beforeParse(buffer) == FilterAction::SKIP))) {
+        return std::nullopt;
+    };
+    const events::TupleProjection *projection = nullptr;
+    const auto &offer = [&buffer, &projection](const auto &filter) {
+        if constexpr (requires { filter.rowProjection(buffer); }) {
+            if (projection == nullptr) {
+                projection = filter.rowProjection(buffer);
+            };
+        };
+    };
+    (offer(filters), ...);
+    auto result = parseProjectedEvent<Context>(buffer, resource, projection);
+    if (!result.has_value()) return std::unexpected(result.error());
+    if ((... ||
+         (filters.afterParse(result.value()) == FilterAction::SKIP))) {
+        return std::nullopt;
+    };
+    return std::move(result.value());
+};
+
+// A session with filters registered on it, e.g.
+// FilteredSession<Context, OriginFilter<Context>, RelationFilter<Context>>
+// drops loop-back transactions and unwanted relations in a single pass.
+template <typename Context, EventFilter<typename Context::Event>... Filters>
+class FilteredSession {
+   public:
+    using Event = typename Context::Event;
+    using EventBatch = typename Context::EventBatch;
+
+    explicit FilteredSession(Filters... filters)
+        : filters(std::move(filters)...) {};
+
+    template <typename Filter>
+    Filter &filter() {
+        return std::get<Filter>(filters);
+    };
+
+    template <typename Filter>
+    const Filter &filter() const {
+        return std::get<Filter>(filters);
+    };
+
+    // Returns std::nullopt for messages skipped by one of the filters.
+    std::expected<std::optional<Event>, ParseError> parseEvent(
+        const std::span<char> &buffer,
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource()) {
+        return std::apply(
+            [&buffer, resource](Filters &...registered) {
+                return parseFiltered<Context>(buffer, resource, registered...);
+            },
+            filters);
+    };
+
+    // Like SessionContext::parseEvents, leaving skipped messages out of out.
+    std::size_t parseEvents(const std::span<const std::span<char>> &messages,
+                            EventBatch &out,
+                            std::pmr::memory_resource *resource =
+                                std::pmr::get_default_resource()) {
+        return parseBatch(messages, out,
+                          [this, resource](const std::span<char> &buffer) {
+                              return parseEvent(buffer, resource);
+                          });
+    };
+
+   private:
+    std::tuple<Filters...> filters;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -10,6 +10,8 @@ enum class MessagesValue { ON, OFF };
 enum class TwoPhaseValue { ON, OFF };
 enum class OriginValue { NONE, ANY };
 enum class IsParallelValue { TRUE, FALSE };
+enum class TupleStorageValue { OWNED, BORROWED, LAZY, PACKED, ARENA };
+enum class ValidationValue { HARDENED, TRUSTED };
 
 constexpr StreamingEnabledValue streamingValueToStreamingEnabledValue(
     const StreamingValue &value) {
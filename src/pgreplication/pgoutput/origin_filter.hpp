@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./batch.hpp"
+#include "./filter.hpp"
+#include "pgreplication/error.hpp"
+#include "pgreplication/pgoutput/events/base/begin.hpp"
+#include "pgreplication/pgoutput/events/base/commit.hpp"
+#include "pgreplication/pgoutput/events/base/event.hpp"
+#include "pgreplication/pgoutput/events/origin.hpp"
+#include "pgreplication/pgoutput/events/stream.hpp"
+#include "pgreplication/pgoutput/events/stream_and_twophase.hpp"
+#include "pgreplication/pgoutput/events/twophase.hpp"
+#include "pgreplication/pgoutput/options.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Drops the transactions replicated from one of the given origins, e.g. the
+// changes a bidirectional setup applied locally and would otherwise send
+// back. Once an Origin message with a filtered name follows Begin (or
+// BeginPrepare, or the StreamStart of a streamed transaction), every
+// message up to the end of the transaction is skipped by its type byte
+// without being parsed. Begin and the closing Commit/Prepare are still
+// returned, so LSN tracking sees an empty transaction. Relation and Type
+// messages are always parsed and returned too: pgoutput sends a relation's
+// schema only once, in the first transaction touching it, so dropping them
+// would leave later rows of that relation undecodable. Streamed
+// transactions stay filtered across all of their segments until
+// StreamCommit, StreamPrepare or the StreamAbort of the top transaction.
+//
+// Skipped messages are not validated, whatever the session's Validation.
+// Use parseEvent/parseEvents on their own, or register the filter on a
+// FilteredSession to combine it with others such as RelationFilter.
+template <typename Context>
+class OriginFilter {
+   public:
+    using Event = typename Context::Event;
+    using EventBatch = typename Context::EventBatch;
+
+    static_assert(Context::OriginInfo == OriginValue::ANY,
+                  "origin filtering requires a session with origin=any");
+
+    explicit OriginFilter(std::vector<std::string> origins)
+        : origins(std::move(origins)) {};
+
+    // Returns std::nullopt for the messages of a filtered transaction.
+    std::expected<std::optional<Event>, ParseError> parseEvent(
+        const std::span<char> &buffer,
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource()) {
+        return parseFiltered<Context>(buffer, resource, *this);
+    };
+
+    // Like SessionContext::parseEvents, leaving filtered messages out of out.
+    std::size_t parseEvents(const std::span<const std::span<char>> &messages,
+                            EventBatch &out,
+                            std::pmr::memory_resource *resource =
+                                std::pmr::get_default_resource()) {
+        return parseBatch(messages, out,
+                          [this, resource](const std::span<char> &buffer) {
+                              return parseEvent(buffer, resource);
+                          });
+    };
+
+    bool filtered(std::string_view origin) const {
+        return std::ranges::find(origins, origin) != origins.end();
+    };
+    bool inFilteredTransaction() const { return skipping; };
+    std::size_t skipped() const { return skippedMessages; };
+
+    void reset() {
+        skipping = false;
+        streamTransactionId.reset();
+        filteredStreams.clear();
+    };
+
+    FilterAction beforeParse(const std::span<char> &buffer) {
+        if (!skipping || buffer.empty() || mustParse(buffer[0])) {
+            return FilterAction::KEEP;
+        };
+        skippedMessages++;
+        return FilterAction::SKIP;
+    };
+
+    FilterAction afterParse(Event &event) {
+        if (std::holds_alternative<events::Origin>(event) &&
+            filtered(std::get<events::Origin>(event).origin)) {
+            skipping = true;
+            if (streamTransactionId.has_value()) {
+                filteredStreams.insert(streamTransactionId.value());
+            };
+            skippedMessages++;
+            return FilterAction::SKIP;
+        };
+        std::visit([this](const auto &value) { observe(value); }, event);
+        return FilterAction::KEEP;
+    };
+
+   private:
+    // Messages that start or end a transaction or stream segment, and the
+    // schema messages, are always parsed; everything else can be skipped.
+    static bool mustParse(char type) {
+        using enum events::BaseEventType;
+        using enum events::StreamingEventType;
+        using enum events::TwoPhaseCommitEventType;
+        using enum events::StreamingAndTwoPhaseCommitEventType;
+        switch (type) {
+            case static_cast<char>(RELATION):
+            case static_cast<char>(TYPE):
+            case static_cast<char>(BEGIN):
+            case static_cast<char>(BEGIN_PREPARE):
+            case static_cast<char>(STREAM_START):
+            case static_cast<char>(COMMIT):
+            case static_cast<char>(PREPARE):
+            case static_cast<char>(STREAM_STOP):
+            case static_cast<char>(STREAM_COMMIT):
+            case static_cast<char>(STREAM_ABORT):
+            case static_cast<char>(STREAM_PREPARE):
+                return true;
+        };
+        return false;
+    };
+
+    void observe(const events::Begin &) { skipping = false; };
+    void observe(const events::BeginPrepare &) { skipping = false; };
+    void observe(const events::Commit &) { skipping = false; };
+    void observe(const events::Prepare &) { skipping = false; };
+
+    void observe(const events::StreamStart &start) {
+        streamTransactionId = start.transactionId;
+        skipping = filteredStreams.contains(start.transactionId);
+    };
+    void observe(const events::StreamStop &) {
+        streamTransactionId.reset();
+        skipping = false;
+    };
+    void observe(const events::StreamCommit &commit) {
+        filteredStreams.erase(commit.transactionId);
+    };
+    void observe(const events::StreamPrepare &prepare) {
+        filteredStreams.erase(prepare.transactionId);
+    };
+    template <StreamingValue Streaming>
+    void observe(const events::StreamAbort<Streaming> &abort) {
+        if (abort.transactionId == abort.subTransactionId) {
+            filteredStreams.erase(abort.transactionId);
+        };
+    };
+
+    template <typename T>
+    void observe(const T &) {};
+
+    std::vector<std::string> origins;
+    bool skipping = false;
+    std::optional<std::int32_t> streamTransactionId;
+    std::unordered_set<std::int32_t> filteredStreams;
+    std::size_t skippedMessages = 0;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
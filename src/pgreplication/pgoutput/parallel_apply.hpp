@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./options.hpp"
+#include "pgreplication/error.hpp"
+#include "pgreplication/pgoutput/events/stream.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Applies transactions concurrently on a fixed pool of workers. Every
+// transaction, streamed (StreamStart ... StreamCommit/StreamAbort) or not
+// (Begin ... Commit, BeginPrepare ... Prepare), is pinned to one worker for
+// its whole lifetime and that worker sees its events in order. Commit
+// events (Commit and StreamCommit, and with two-phase Prepare,
+// StreamPrepare, CommitPrepared and RollbackPrepared) are handed to the
+// handler strictly in the order they were dispatched: a worker reaching a
+// commit waits until every earlier commit has returned. flushedLsn() is
+// only advanced after a commit returns, so it never passes a transaction
+// that is still being applied.
+//
+// Events outside any transaction (e.g. non-transactional messages) are
+// handled on the dispatching thread. A StreamAbort for a transaction that
+// was never started fails dispatch() with UNEXPECTED_EVENT.
+// Events are moved to other threads, so the session must use OWNED or
+// PACKED tuple storage and a thread safe memory resource. dispatch() and
+// drain() must be called from a single thread; they rethrow the first
+// exception thrown by the handler, after which no further commits are
+// applied.
+template <typename Context>
+class ParallelApplyScheduler {
+   public:
+    using Event = typename Context::Event;
+    using Handler = std::function<void(const Event &)>;
+
+    static_assert(Context::StreamingEnabled == StreamingEnabledValue::ON,
+                  "parallel apply requires a streaming session");
+    static_assert(Context::TupleStorage == TupleStorageValue::OWNED ||
+                      Context::TupleStorage == TupleStorageValue::PACKED,
+                  "events handed to workers must own their tuple data");
+
+    ParallelApplyScheduler(std::size_t workerCount, Handler handler)
+        : handler(std::move(handler)) {
+        const auto count = std::max<std::size_t>(workerCount, 1);
+        workers.reserve(count);
+        for (std::size_t index = 0; index < count; index++) {
+            workers.push_back(std::make_unique<Worker>());
+        };
+        for (auto &worker : workers) {
+            worker->thread = std::jthread(
+                [this, &target = *worker](std::stop_token stopToken) {
+                    run(target, stopToken);
+                });
+        };
+    };
+
+    ~ParallelApplyScheduler() {
+        waitIdle();
+        for (auto &worker : workers) {
+            worker->thread.request_stop();
+            worker->wakeup.notify_all();
+        };
+        for (auto &worker : workers) worker->thread.join();
+    };
+
+    ParallelApplyScheduler(const ParallelApplyScheduler &) = delete;
+    ParallelApplyScheduler &operator=(const ParallelApplyScheduler &) =
+        delete;
+
+    std::expected<void, ParseError> dispatch(Event &&event) {
+        rethrowFailure();
+        using events = typename Context::events;
+        if constexpr (Context::TwoPhase == TwoPhaseValue::ON) {
+            if (dispatchTwoPhase(event)) return {};
+        };
+        if (const auto *start = std::get_if<typename events::StreamStart>(
+                &event)) {
+            current = start->transactionId;
+            enqueue(assign(start->transactionId),
+                    { .event = std::move(event) });
+            return {};
+        };
+        if (const auto *begin = std::get_if<typename events::Begin>(&event)) {
+            current = begin->transactionId;
+            enqueue(assign(begin->transactionId),
+                    { .event = std::move(event) });
+            return {};
+        };
+        if (std::holds_alternative<typename events::StreamStop>(event)) {
+            if (current.has_value()) {
+                enqueue(assign(current.value()),
+                        { .event = std::move(event) });
+            };
+            current.reset();
+            return {};
+        };
+        if (const auto *commit =
+                std::get_if<typename events::StreamCommit>(&event)) {
+            const auto transactionId = commit->transactionId;
+            enqueueCommit(transactionId, commit->endLsn, std::move(event));
+            return {};
+        };
+        if (std::holds_alternative<typename events::Commit>(event) &&
+            current.has_value()) {
+            const auto transactionId = current.value();
+            const auto endLsn =
+                std::get<typename events::Commit>(event).endLsn;
+            current.reset();
+            enqueueCommit(transactionId, endLsn, std::move(event));
+            return {};
+        };
+        if (const auto *abort =
+                std::get_if<typename events::StreamAbort>(&event)) {
+            const auto transactionId = abort->transactionId;
+            const auto topLevel = abort->subTransactionId == transactionId;
+            const auto &it = assignments.find(transactionId);
+            if (it == assignments.end()) {
+                return std::unexpected(ParseError{
+                    .code = ParseErrorCode::UNEXPECTED_EVENT,
+                    .eventType = static_cast<char>(
+                        pgoutput::events::StreamingEventType::STREAM_ABORT) });
+            };
+            enqueue(it->second, { .event = std::move(event) });
+            if (topLevel) release(transactionId);
+            return {};
+        };
+        if (current.has_value()) {
+            enqueue(assign(current.value()), { .event = std::move(event) });
+            return {};
+        };
+        handler(event);
+        return {};
+    };
+
+    // Blocks until every dispatched event has been handled.
+    void drain() {
+        waitIdle();
+        rethrowFailure();
+    };
+
+    std::int64_t flushedLsn() const {
+        return flushed.load(std::memory_order_acquire);
+    };
+    std::size_t inFlight() const { return assignments.size(); };
+    std::size_t workerCount() const { return workers.size(); };
+
+   private:
+    struct Task {
+        Event event;
+        std::uint64_t ticket = 0;
+        std::int64_t endLsn = 0;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable_any wakeup;
+        std::condition_variable_any idle;
+        std::deque<Task> tasks;
+        bool busy = false;
+        std::size_t transactions = 0;
+        std::jthread thread;
+    };
+
+    std::size_t assign(std::int32_t transactionId) {
+        const auto &[it, inserted] =
+            assignments.try_emplace(transactionId, 0);
+        if (inserted) {
+            const auto &least = std::ranges::min_element(
+                workers, {}, [](const auto &worker) {
+                    return worker->transactions;
+                });
+            it->second = static_cast<std::size_t>(least - workers.begin());
+            workers[it->second]->transactions++;
+        };
+        return it->second;
+    };
+
+    // Two-phase transactions are pinned like Begin ... Commit; Prepare and
+    // StreamPrepare end them, CommitPrepared and RollbackPrepared only need
+    // to follow the Prepare, which their commit ticket guarantees.
+    bool dispatchTwoPhase(Event &event) {
+        using events = typename Context::events;
+        if (const auto *begin =
+                std::get_if<typename events::BeginPrepare>(&event)) {
+            current = begin->transactionId;
+            enqueue(assign(begin->transactionId),
+                    { .event = std::move(event) });
+            return true;
+        };
+        if (std::holds_alternative<typename events::Prepare>(event)) {
+            current.reset();
+        };
+        return enqueueTwoPhaseCommit<typename events::Prepare>(event) ||
+               enqueueTwoPhaseCommit<typename events::StreamPrepare>(event) ||
+               enqueueTwoPhaseCommit<typename events::CommitPrepared>(event) ||
+               enqueueTwoPhaseCommit<typename events::RollbackPrepared>(event);
+    };
+
+    template <typename T>
+    bool enqueueTwoPhaseCommit(Event &event) {
+        const auto *commit = std::get_if<T>(&event);
+        if (commit == nullptr) return false;
+        enqueueCommit(commit->transactionId, commit->endLsn, std::move(event));
+        return true;
+    };
+
+    void release(std::int32_t transactionId) {
+        const auto &it = assignments.find(transactionId);
+        if (it == assignments.end()) return;
+        workers[it->second]->transactions--;
+        assignments.erase(it);
+    };
+
+    void enqueueCommit(std::int32_t transactionId, std::int64_t endLsn,
+                       Event &&event) {
+        const auto worker = assign(transactionId);
+        enqueue(worker, { .event = std::move(event),
+                          .ticket = ++issuedTickets,
+                          .endLsn = endLsn });
+        release(transactionId);
+    };
+
+    void enqueue(std::size_t index, Task &&task) {
+        auto &worker = *workers[index];
+        {
+            std::lock_guard lock(worker.mutex);
+            worker.tasks.emplace_back(std::move(task));
+        };
+        worker.wakeup.notify_one();
+    };
+
+    void run(Worker &worker, std::stop_token stopToken) {
+        while (true) {
+            std::unique_lock lock(worker.mutex);
+            if (!worker.wakeup.wait(lock, stopToken, [&worker] {
+                    return !worker.tasks.empty();
+                })) {
+                return;
+            };
+            auto task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            worker.busy = true;
+            lock.unlock();
+
+            if (task.ticket != 0) {
+                // Tickets are issued in dispatch order and each worker's
+                // queue is FIFO, so the lowest outstanding ticket is always
+                // at the front of some queue and this cannot deadlock.
+                auto completed = completedTickets.load();
+                while (completed != task.ticket - 1) {
+                    completedTickets.wait(completed);
+                    completed = completedTickets.load();
+                };
+            };
+            if (!failed.load(std::memory_order_acquire)) {
+                try {
+                    handler(task.event);
+                    if (task.ticket != 0) {
+                        flushed.store(task.endLsn, std::memory_order_release);
+                    };
+                } catch (...) {
+                    std::lock_guard failureLock(failureMutex);
+                    if (!failure) failure = std::current_exception();
+                    failed.store(true, std::memory_order_release);
+                };
+            };
+            if (task.ticket != 0) {
+                completedTickets.store(task.ticket);
+                completedTickets.notify_all();
+            };
+
+            lock.lock();
+            worker.busy = false;
+            if (worker.tasks.empty()) worker.idle.notify_all();
+        };
+    };
+
+    void waitIdle() {
+        for (auto &worker : workers) {
+            std::unique_lock lock(worker->mutex);
+            worker->idle.wait(lock, [&worker] {
+                return worker->tasks.empty() && !worker->busy;
+            });
+        };
+    };
+
+    void rethrowFailure() {
+        if (!failed.load(std::memory_order_acquire)) return;
+        std::lock_guard lock(failureMutex);
+        std::rethrow_exception(failure);
+    };
+
+    Handler handler;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unordered_map<std::int32_t, std::size_t> assignments;
+    std::optional<std::int32_t> current;
+    std::uint64_t issuedTickets = 0;
+    std::atomic<std::uint64_t> completedTickets = 0;
+    std::atomic<std::int64_t> flushed = 0;
+    std::atomic<bool> failed = false;
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cstddef>
+#include <expected>
+#include <memory_resource>
+#include <span>
 #include <string>
 #include <type_traits>
 
+#include "./batch.hpp"
 #include "./events/event.hpp"
 #include "./options.hpp"
+#include "pgreplication/error.hpp"
 #include "pgreplication/pgoutput/events/base/begin.hpp"
 #include "pgreplication/pgoutput/events/base/commit.hpp"
 #include "pgreplication/pgoutput/events/base/delete.hpp"
@@ -21,9 +27,17 @@
 #include "pgreplication/pgoutput/events/twophase.hpp"
 
 namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Validation selects how much parseEvent trusts its input. HARDENED (the
+// default) bounds checks every length prefix and string before decoding and
+// reports malformed messages as ParseError, which is what replaying files or
+// any other untrusted source needs. TRUSTED decodes without any check and
+// is only safe on messages produced by the server itself, such as a direct
+// walsender feed; a malformed message is undefined behavior.
 template <BinaryValue TBinary, MessagesValue TMessages,
           StreamingValue TStreaming, TwoPhaseValue TTwoPhase,
-          OriginValue TOriginInfo>
+          OriginValue TOriginInfo,
+          TupleStorageValue TTupleStorage = TupleStorageValue::OWNED,
+          ValidationValue TValidation = ValidationValue::HARDENED>
 struct SessionContext {
     constexpr static auto Binary = TBinary;
     constexpr static auto Messages = TMessages;
@@ -32,11 +46,34 @@ struct SessionContext {
         streamingValueToStreamingEnabledValue(Streaming);
     constexpr static auto TwoPhase = TTwoPhase;
     constexpr static auto OriginInfo = TOriginInfo;
-    using Event =
-        events::Event<Binary, Messages, Streaming, TwoPhase, OriginInfo>;
+    constexpr static auto TupleStorage = TTupleStorage;
+    constexpr static auto Validation = TValidation;
+    using Event = events::Event<Binary, Messages, Streaming, TwoPhase,
+                                OriginInfo, TupleStorage>;
 
-    constexpr static auto parseEvent =
-        events::parseEvent<Binary, Messages, Streaming, TwoPhase, OriginInfo>;
+    static std::expected<Event, ParseError> parseEvent(
+        const std::span<char> &buffer,
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource()) {
+        return PGREPLICATION_NAMESPACE::pgoutput::events::parseEvent<
+            Binary, Messages, Streaming, TwoPhase, OriginInfo, TupleStorage,
+            Validation>(buffer, resource);
+    };
+
+    using EventBatch = pgoutput::EventBatch<Event>;
+
+    // Appends the events parsed from messages to out and returns how many
+    // were added. Parsing stops at the first malformed message, which is
+    // recorded in out.error.
+    static std::size_t parseEvents(
+        const std::span<const std::span<char>> &messages, EventBatch &out,
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource()) {
+        return parseBatch(messages, out,
+                          [resource](const std::span<char> &buffer) {
+                              return parseEvent(buffer, resource);
+                          });
+    };
 
     constexpr static std::string buildStaticOptions() {
         return buildPgoutputStaticOptions<Binary, Messages, Streaming, TwoPhase,
@@ -53,15 +90,12 @@ struct SessionContext {
             StreamingEnabled>;
         using Type =
             PGREPLICATION_NAMESPACE::pgoutput::events::Type<StreamingEnabled>;
-        using Insert =
-            PGREPLICATION_NAMESPACE::pgoutput::events::Insert<Binary,
-                                                              StreamingEnabled>;
-        using Update =
-            PGREPLICATION_NAMESPACE::pgoutput::events::Update<Binary,
-                                                              StreamingEnabled>;
-        using Delete =
-            PGREPLICATION_NAMESPACE::pgoutput::events::Delete<Binary,
-                                                              StreamingEnabled>;
+        using Insert = PGREPLICATION_NAMESPACE::pgoutput::events::Insert<
+            Binary, StreamingEnabled, TupleStorage>;
+        using Update = PGREPLICATION_NAMESPACE::pgoutput::events::Update<
+            Binary, StreamingEnabled, TupleStorage>;
+        using Delete = PGREPLICATION_NAMESPACE::pgoutput::events::Delete<
+            Binary, StreamingEnabled, TupleStorage>;
         using Truncate = PGREPLICATION_NAMESPACE::pgoutput::events::Truncate<
             StreamingEnabled>;
 
@@ -87,9 +121,10 @@ struct SessionContext {
             PGREPLICATION_NAMESPACE::pgoutput::events::StreamPrepare;
 
         using TupleData =
-            PGREPLICATION_NAMESPACE::pgoutput::events::TupleData<Binary>;
-        using TupleDataColumn =
-            PGREPLICATION_NAMESPACE::pgoutput::events::TupleDataColumn<Binary>;
+            PGREPLICATION_NAMESPACE::pgoutput::events::StoredTupleData<
+                Binary, TupleStorage>;
+        using TupleDataColumn = typename PGREPLICATION_NAMESPACE::pgoutput::
+            events::TupleDataStorage<Binary, TupleStorage>::column_type;
     };
 };
 };  // namespace PGREPLICATION_NAMESPACE::pgoutput
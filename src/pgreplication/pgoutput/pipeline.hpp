@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./options.hpp"
+#include "./spsc_queue.hpp"
+#include "pgreplication/copy_data.hpp"
+#include "pgreplication/error.hpp"
+#include "pgreplication/events.hpp"
+#include "pgreplication/utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+struct ReplicationPipelineStats {
+    std::size_t receivedBytes;
+    std::size_t receivedMessages;
+    std::size_t appliedEvents;
+    // Times the receive stage waited for a block to be recycled.
+    std::size_t receiveStalls;
+    std::size_t parseQueueDepth;
+    std::size_t applyQueueDepth;
+    std::size_t freeBlocks;
+};
+
+// Runs receive, parse and apply on three threads. The receive stage reads
+// the COPY BOTH byte stream from source straight into a block taken from a
+// fixed pool and splits it into XLogData messages in place; the parse stage
+// runs Context::parseEvents over the block's messages into the block's own
+// batch and arena; the apply stage hands each event to sink and then
+// recycles the block. Blocks travel between stages through SpscQueues, so
+// message bytes are never copied, except for the head of a message split
+// across the end of a block which moves to the next block.
+//
+// A block is passed on as soon as it holds complete messages and the parse
+// stage is idle, or once it is full, so batches grow with the load. With
+// every block in flight the receive stage stops reading until the sink
+// catches up, which bounds memory to blockCount * blockSize; messages
+// larger than blockSize are rejected with MESSAGE_TOO_LARGE. Events may
+// borrow from their block, so any TupleStorage works.
+//
+// source reads into the given buffer and returns the number of bytes read,
+// 0 at the end of the stream. The stream also ends on CopyDone, a parse or
+// framing error, an exception thrown by sink or stop(); a source blocked in
+// a read has to be woken up by the caller. Keepalives only update
+// serverWalEnd(); sending standby status updates built from appliedLsn()
+// is left to the caller.
+template <typename Context>
+class ReplicationPipeline {
+   public:
+    using Event = typename Context::Event;
+    using Source = std::function<std::size_t(std::span<char>)>;
+    using Sink = std::function<void(const Event &)>;
+
+    constexpr static std::size_t defaultBlockSize = 1024 * 1024;
+    constexpr static std::size_t defaultBlockCount = 8;
+
+    ReplicationPipeline(Source source, Sink sink,
+                        std::size_t blockSize = defaultBlockSize,
+                        std::size_t blockCount = defaultBlockCount)
+        : source(std::move(source)),
+          sink(std::move(sink)),
+          parseQueue(std::max<std::size_t>(blockCount, 2) + 1),
+          applyQueue(std::max<std::size_t>(blockCount, 2) + 1),
+          freeQueue(std::max<std::size_t>(blockCount, 2) + 1) {
+        // One block per usable freeQueue slot; a further push would block
+        // here, before any stage runs to drain the queue.
+        const auto count = std::max<std::size_t>(blockCount, 2);
+        blocks.reserve(count);
+        for (std::size_t index = 0; index < count; index++) {
+            blocks.push_back(std::make_unique<Block>(
+                std::max(blockSize, CopyDataFramer::headerSize)));
+            freeQueue.push(blocks.back().get());
+        };
+        applyThread = std::jthread([this] { apply(); });
+        parseThread = std::jthread([this] { parse(); });
+        receiveThread = std::jthread([this] { receive(); });
+    };
+
+    ~ReplicationPipeline() {
+        stop();
+        join();
+    };
+
+    ReplicationPipeline(const ReplicationPipeline &) = delete;
+    ReplicationPipeline &operator=(const ReplicationPipeline &) = delete;
+
+    // Asks the receive stage to end the stream after the current read.
+    void stop() { stopping.store(true, std::memory_order_release); };
+
+    // Waits until every stage finished, then rethrows the exception thrown
+    // by sink or returns the error that ended the stream.
+    std::expected<void, ParseError> wait() {
+        join();
+        std::lock_guard lock(failureMutex);
+        if (failure) std::rethrow_exception(failure);
+        if (error.has_value()) return std::unexpected(error.value());
+        return {};
+    };
+
+    // End LSN of the last Commit/StreamCommit that sink returned from.
+    std::int64_t appliedLsn() const {
+        return applied.load(std::memory_order_acquire);
+    };
+    std::int64_t serverWalEnd() const {
+        return walEnd.load(std::memory_order_acquire);
+    };
+
+    ReplicationPipelineStats stats() const {
+        return { .receivedBytes = receivedBytes.load(),
+                 .receivedMessages = receivedMessages.load(),
+                 .appliedEvents = appliedEvents.load(),
+                 .receiveStalls = receiveStalls.load(),
+                 .parseQueueDepth = parseQueue.size(),
+                 .applyQueueDepth = applyQueue.size(),
+                 .freeBlocks = freeQueue.size() };
+    };
+
+   private:
+    struct Block {
+        explicit Block(std::size_t capacity)
+            : data(std::make_unique_for_overwrite<char[]>(capacity)),
+              capacity(capacity) {};
+
+        std::unique_ptr<char[]> data;
+        std::size_t capacity;
+        std::size_t size = 0;
+        std::vector<std::span<char>> messages;
+        typename Context::EventBatch batch;
+        std::pmr::monotonic_buffer_resource resource;
+    };
+
+    Block *acquire() {
+        if (freeQueue.front() == nullptr) {
+            receiveStalls.fetch_add(1, std::memory_order_relaxed);
+        };
+        auto *block = freeQueue.waitFront();
+        freeQueue.pop();
+        return block;
+    };
+
+    void fail(const ParseError &parseError) {
+        std::lock_guard lock(failureMutex);
+        if (!error.has_value()) error = parseError;
+        stopping.store(true, std::memory_order_release);
+    };
+
+    void updateWalEnd(std::int64_t lsn) {
+        auto current = walEnd.load(std::memory_order_relaxed);
+        while (current < lsn && !walEnd.compare_exchange_weak(current, lsn)) {
+        };
+    };
+
+    // Splits the complete frames of block after offset framed, returning
+    // false once the stream ended.
+    bool splitFrames(Block &block, std::size_t &framed) {
+        while (true) {
+            const auto &frame = frameCopyData(
+                std::span(block.data.get() + framed, block.size - framed),
+                block.capacity);
+            if (!frame.has_value()) {
+                fail(frame.error());
+                return false;
+            };
+            if (!frame.value().has_value()) return true;
+            const auto &[type, payload] = frame.value().value();
+            framed += CopyDataFramer::headerSize + payload.size();
+            if (type == static_cast<char>(CopyMessageType::CopyDone)) {
+                return false;
+            };
+            if (type != static_cast<char>(CopyMessageType::CopyData)) {
+                fail(ParseError{ .code = ParseErrorCode::UNEXPECTED_TYPE,
+                                 .eventType = type });
+                return false;
+            };
+            const auto &event = primaryEventFromNetworkBuffer(payload);
+            if (!event.has_value()) {
+                fail(event.error());
+                return false;
+            };
+            std::visit(utils::overloaded{
+                           [this, &block](const XLogData &data) {
+                               block.messages.push_back(data.walData);
+                               updateWalEnd(data.serverWalEnd);
+                           },
+                           [this](const PrimaryKeepaliveMessage &keepalive) {
+                               updateWalEnd(keepalive.serverWalEnd);
+                           } },
+                       event.value());
+        };
+    };
+
+    void receive() {
+        auto *block = acquire();
+        std::size_t framed = 0;
+        bool open = true;
+        while (open && !stopping.load(std::memory_order_acquire)) {
+            const auto &read = source(std::span(block->data.get() + block->size,
+                                                block->capacity - block->size));
+            if (read == 0) break;
+            block->size += read;
+            receivedBytes.fetch_add(read, std::memory_order_relaxed);
+            const auto &messages = block->messages.size();
+            open = splitFrames(*block, framed);
+            receivedMessages.fetch_add(block->messages.size() - messages,
+                                       std::memory_order_relaxed);
+
+            const auto full = block->size == block->capacity;
+            if (block->messages.empty()) {
+                if (full) {
+                    // Only keepalives so far, make room in place.
+                    std::memmove(block->data.get(), block->data.get() + framed,
+                                 block->size - framed);
+                    block->size -= framed;
+                    framed = 0;
+                };
+                continue;
+            };
+            if (!open || (!full && parseQueue.size() != 0)) continue;
+            auto *next = acquire();
+            next->size = block->size - framed;
+            std::memcpy(next->data.get(), block->data.get() + framed,
+                        next->size);
+            block->size = framed;
+            parseQueue.push(std::move(block));
+            block = next;
+            framed = 0;
+        };
+        if (!block->messages.empty()) {
+            parseQueue.push(std::move(block));
+        } else {
+            // The receive thread only consumes freeQueue; the block is
+            // simply left out of the rotation once the stream ended.
+            block->size = 0;
+        };
+        parseQueue.push(nullptr);
+    };
+
+    void parse() {
+        while (true) {
+            auto *block = parseQueue.waitFront();
+            parseQueue.pop();
+            if (block != nullptr && !stopping.load(std::memory_order_acquire)) {
+                Context::parseEvents(block->messages, block->batch,
+                                     &block->resource);
+                if (!block->batch.ok()) fail(block->batch.error->error);
+            };
+            applyQueue.push(std::move(block));
+            if (block == nullptr) return;
+        };
+    };
+
+    void apply() {
+        using events = typename Context::events;
+        while (true) {
+            auto *block = applyQueue.waitFront();
+            applyQueue.pop();
+            if (block == nullptr) return;
+            if (!failed) {
+                try {
+                    for (const auto &event : block->batch.events) {
+                        sink(event);
+                        appliedEvents.fetch_add(1, std::memory_order_relaxed);
+                        if (const auto *commit =
+                                std::get_if<typename events::Commit>(&event)) {
+                            applied.store(commit->endLsn,
+                                          std::memory_order_release);
+                        };
+                        if constexpr (Context::StreamingEnabled ==
+                                      StreamingEnabledValue::ON) {
+                            if (const auto *commit = std::get_if<
+                                    typename events::StreamCommit>(&event)) {
+                                applied.store(commit->endLsn,
+                                              std::memory_order_release);
+                            };
+                        };
+                    };
+                } catch (...) {
+                    std::lock_guard lock(failureMutex);
+                    failure = std::current_exception();
+                    failed = true;
+                    stopping.store(true, std::memory_order_release);
+                };
+            };
+            block->batch.clear();
+            block->messages.clear();
+            block->resource.release();
+            block->size = 0;
+            freeQueue.push(std::move(block));
+        };
+    };
+
+    void join() {
+        if (receiveThread.joinable()) receiveThread.join();
+        if (parseThread.joinable()) parseThread.join();
+        if (applyThread.joinable()) applyThread.join();
+    };
+
+    Source source;
+    Sink sink;
+    std::vector<std::unique_ptr<Block>> blocks;
+    SpscQueue<Block *> parseQueue;
+    SpscQueue<Block *> applyQueue;
+    SpscQueue<Block *> freeQueue;
+    std::atomic<bool> stopping = false;
+    std::atomic<std::int64_t> applied = 0;
+    std::atomic<std::int64_t> walEnd = 0;
+    std::atomic<std::size_t> receivedBytes = 0;
+    std::atomic<std::size_t> receivedMessages = 0;
+    std::atomic<std::size_t> appliedEvents = 0;
+    std::atomic<std::size_t> receiveStalls = 0;
+    // Only touched by the apply thread.
+    bool failed = false;
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+    std::optional<ParseError> error;
+    std::jthread applyThread;
+    std::jthread parseThread;
+    std::jthread receiveThread;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./batch.hpp"
+#include "./filter.hpp"
+#include "pgreplication/error.hpp"
+#include "pgreplication/pgoutput/events/base/event.hpp"
+#include "pgreplication/pgoutput/events/base/tuple_data.hpp"
+#include "pgreplication/pgoutput/options.hpp"
+#include "pgreplication/utils.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Restricts a session to an allowlist of relations, optionally projected to
+// some of their columns. Rules are given by name and resolved to oids as
+// Relation messages arrive. Insert/Update/Delete messages are checked right
+// after their oid field: rows of other relations are skipped without
+// parsing their tuples, and rows of projected relations only decode the
+// projected columns. Relation messages of projected relations are
+// delivered with the same columns, so tuples and relations keep lining up
+// for RelationCache and ColumnarAccumulator. Truncate messages lose the
+// oids that are not allowed and are dropped when none remain.
+//
+// Rows of a relation whose Relation message has not been seen yet are
+// skipped. Skipped messages are not validated, whatever the session's
+// Validation. Use parseEvent/parseEvents on their own, or register the
+// filter on a FilteredSession to combine it with others such as
+// OriginFilter.
+template <typename Context>
+class RelationFilter {
+   public:
+    using Event = typename Context::Event;
+    using EventBatch = typename Context::EventBatch;
+
+    // Keeps the rows of relationNamespace.name. When columns is not empty
+    // only those columns are parsed; unknown column names are ignored.
+    void allow(std::string relationNamespace, std::string name,
+               std::vector<std::string> columns = {}) {
+        rules.insert_or_assign(
+            std::pair(std::move(relationNamespace), std::move(name)),
+            std::move(columns));
+    };
+
+    // Returns std::nullopt for filtered messages.
+    std::expected<std::optional<Event>, ParseError> parseEvent(
+        const std::span<char> &buffer,
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource()) {
+        return parseFiltered<Context>(buffer, resource, *this);
+    };
+
+    // Like SessionContext::parseEvents, leaving filtered messages out of out.
+    std::size_t parseEvents(const std::span<const std::span<char>> &messages,
+                            EventBatch &out,
+                            std::pmr::memory_resource *resource =
+                                std::pmr::get_default_resource()) {
+        return parseBatch(messages, out,
+                          [this, resource](const std::span<char> &buffer) {
+                              return parseEvent(buffer, resource);
+                          });
+    };
+
+    bool allowed(std::int32_t oid) const { return relations.contains(oid); };
+
+    // nullptr when the relation is not allowed or keeps all columns.
+    const events::TupleProjection *projection(std::int32_t oid) const {
+        const auto &it = relations.find(oid);
+        if (it == relations.end() || !it->second.has_value()) return nullptr;
+        return &it->second.value();
+    };
+
+    std::size_t skipped() const { return skippedMessages; };
+
+    // Forgets resolved oids, e.g. after reconnecting; the server sends the
+    // Relation messages again.
+    void reset() { relations.clear(); };
+
+    FilterAction beforeParse(const std::span<char> &buffer) {
+        const auto &oid = rowOid(buffer);
+        if (!oid.has_value() || allowed(oid.value())) {
+            return FilterAction::KEEP;
+        };
+        return skip();
+    };
+
+    const events::TupleProjection *rowProjection(
+        const std::span<char> &buffer) const {
+        const auto &oid = rowOid(buffer);
+        return oid.has_value() ? projection(oid.value()) : nullptr;
+    };
+
+    FilterAction afterParse(Event &event) {
+        if (auto *relation =
+                std::get_if<typename Context::events::Relation>(&event)) {
+            return filterRelation(*relation);
+        };
+        if (auto *truncate =
+                std::get_if<typename Context::events::Truncate>(&event)) {
+            return filterTruncate(*truncate);
+        };
+        return FilterAction::KEEP;
+    };
+
+   private:
+    constexpr static std::size_t oidOffset =
+        1 + (Context::StreamingEnabled == StreamingEnabledValue::ON
+                 ? sizeof(std::int32_t)
+                 : 0);
+
+    // The oid of an Insert/Update/Delete message, read right after its
+    // type byte (and transaction id in streaming sessions).
+    static std::optional<std::int32_t> rowOid(const std::span<char> &buffer) {
+        if (buffer.size() < oidOffset + sizeof(std::int32_t)) {
+            return std::nullopt;
+        };
+        using enum events::BaseEventType;
+        switch (buffer[0]) {
+            case static_cast<char>(INSERT):
+            case static_cast<char>(UPDATE):
+            case static_cast<char>(DELETE):
+                return ::PGREPLICATION_NAMESPACE::utils::int32FromNetwork(
+                    buffer.subspan(oidOffset)
+                        .template first<sizeof(std::int32_t)>());
+        };
+        return std::nullopt;
+    };
+
+    FilterAction skip() {
+        skippedMessages++;
+        return FilterAction::SKIP;
+    };
+
+    FilterAction filterRelation(typename Context::events::Relation &relation) {
+        const auto &rule = rules.find(
+            std::pair(std::string(relation.relationNamespace),
+                      std::string(relation.name)));
+        if (rule == rules.end()) {
+            relations.erase(relation.oid);
+            return skip();
+        };
+        if (rule->second.empty()) {
+            relations.insert_or_assign(relation.oid, std::nullopt);
+            return FilterAction::KEEP;
+        };
+
+        events::TupleProjection columnProjection;
+        columnProjection.columns.resize(relation.columns.size());
+        std::size_t kept = 0;
+        for (std::size_t index = 0; index < relation.columns.size();
+             index++) {
+            for (const auto &name : rule->second) {
+                if (std::string_view(relation.columns[index].name) != name) {
+                    continue;
+                };
+                columnProjection.columns[index] = true;
+                break;
+            };
+            if (!columnProjection.columns[index]) continue;
+            if (kept != index) {
+                relation.columns[kept] = std::move(relation.columns[index]);
+            };
+            kept++;
+        };
+        relation.columns.resize(kept);
+        relations.insert_or_assign(relation.oid, std::move(columnProjection));
+        return FilterAction::KEEP;
+    };
+
+    FilterAction filterTruncate(typename Context::events::Truncate &truncate) {
+        std::erase_if(truncate.oids,
+                      [this](std::int32_t oid) { return !allowed(oid); });
+        if (truncate.oids.empty()) return skip();
+        return FilterAction::KEEP;
+    };
+
+    std::map<std::pair<std::string, std::string>, std::vector<std::string>>
+        rules;
+    std::unordered_map<std::int32_t, std::optional<events::TupleProjection>>
+        relations;
+    std::size_t skippedMessages = 0;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./options.hpp"
+#include "./spsc_queue.hpp"
+#include "pgreplication/pgoutput/events/base/relation_cache.hpp"
+#include "pgreplication/pgoutput/events/base/tuple_data.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Applies row changes on a fixed number of shard threads. Each
+// Insert/Update/Delete is routed by its relation oid and the values of the
+// relation's key columns (replica identity columns, read from the new tuple
+// or from the old key/row tuple of updates and deletes) and handed over
+// through a bounded SpscQueue, so all changes of one row are applied in
+// order by the same shard while different rows are applied concurrently.
+// Transactions are not applied atomically: a transaction's rows may be
+// spread over all shards.
+//
+// Changes whose key cannot be placed on a single shard are barriers: the
+// dispatcher waits until every shard is idle and handles them itself. That
+// covers updates moving a row to another shard, key values sent as
+// unchanged TOAST, rows of unknown relations, Relation and Truncate. Other
+// events (Begin, Commit, Type, Message, Origin) are handed to the handler
+// on the dispatching thread right away, without waiting for the shards, so
+// acknowledge progress with appliedLsn() rather than on Commit.
+//
+// The handler is called concurrently and must be thread safe. Events are
+// moved to other threads, so the session must use OWNED or PACKED tuple
+// storage and a thread safe memory resource. dispatch(), drain() and
+// appliedLsn() must be called from a single thread; dispatch() and drain()
+// rethrow the first exception thrown by the handler, after which no
+// further changes are applied.
+template <typename Context>
+class ShardedApplyPipeline {
+   public:
+    using Event = typename Context::Event;
+    using Handler = std::function<void(const Event &)>;
+
+    constexpr static std::size_t defaultQueueCapacity = 1024;
+
+    static_assert(Context::StreamingEnabled == StreamingEnabledValue::OFF,
+                  "streamed changes may still be aborted, use "
+                  "ParallelApplyScheduler for streaming sessions");
+    static_assert(Context::TupleStorage == TupleStorageValue::OWNED ||
+                      Context::TupleStorage == TupleStorageValue::PACKED,
+                  "events handed to shards must own their tuple data");
+
+    ShardedApplyPipeline(std::size_t shardCount, Handler handler,
+                         std::size_t queueCapacity = defaultQueueCapacity)
+        : handler(std::move(handler)) {
+        const auto count = std::max<std::size_t>(shardCount, 1);
+        shards.reserve(count);
+        for (std::size_t index = 0; index < count; index++) {
+            shards.push_back(std::make_unique<Shard>(queueCapacity));
+        };
+        for (auto &shard : shards) {
+            shard->thread = std::jthread([this, &target = *shard] {
+                run(target);
+            });
+        };
+    };
+
+    ~ShardedApplyPipeline() {
+        waitIdle();
+        for (auto &shard : shards) {
+            shard->queue.push({ .kind = TaskKind::STOP });
+        };
+        for (auto &shard : shards) shard->thread.join();
+    };
+
+    ShardedApplyPipeline(const ShardedApplyPipeline &) = delete;
+    ShardedApplyPipeline &operator=(const ShardedApplyPipeline &) = delete;
+
+    void dispatch(Event &&event) {
+        rethrowFailure();
+        using events = typename Context::events;
+        if (const auto *insert =
+                std::get_if<typename events::Insert>(&event)) {
+            dispatchRow(route(*insert), std::move(event));
+            return;
+        };
+        if (const auto *update =
+                std::get_if<typename events::Update>(&event)) {
+            dispatchRow(route(*update), std::move(event));
+            return;
+        };
+        if (const auto *remove =
+                std::get_if<typename events::Delete>(&event)) {
+            dispatchRow(route(*remove), std::move(event));
+            return;
+        };
+        if (const auto *relation =
+                std::get_if<typename events::Relation>(&event)) {
+            waitIdle();
+            relations.apply(*relation);
+            handler(event);
+            return;
+        };
+        if (std::holds_alternative<typename events::Truncate>(event)) {
+            waitIdle();
+            handler(event);
+            return;
+        };
+        if (const auto *commit = std::get_if<typename events::Commit>(&event)) {
+            commitLsn = commit->endLsn;
+            for (auto &shard : shards) {
+                if (!shard->touched) continue;
+                enqueue(*shard,
+                        { .kind = TaskKind::COMMIT, .lsn = commitLsn });
+                shard->markerSequence = shard->enqueued;
+                shard->touched = false;
+            };
+        };
+        handler(event);
+    };
+
+    // Blocks until every dispatched change has been applied.
+    void drain() {
+        waitIdle();
+        rethrowFailure();
+    };
+
+    // End LSN of the last Commit whose changes have been applied by every
+    // shard. Never decreases.
+    std::int64_t appliedLsn() {
+        auto lsn = commitLsn;
+        for (const auto &shard : shards) {
+            // A shard past its last commit marker has applied every change
+            // of the committed transactions routed to it.
+            if (shard->applied.load(std::memory_order_acquire) >=
+                shard->markerSequence) {
+                continue;
+            };
+            lsn = std::min(lsn,
+                           shard->appliedLsn.load(std::memory_order_acquire));
+        };
+        watermark = std::max(watermark, lsn);
+        return watermark;
+    };
+
+    std::size_t shardCount() const { return shards.size(); };
+
+   private:
+    enum class TaskKind { CHANGE, COMMIT, STOP };
+
+    struct Task {
+        TaskKind kind = TaskKind::CHANGE;
+        std::int64_t lsn = 0;
+        std::optional<Event> event;
+    };
+
+    struct Shard {
+        explicit Shard(std::size_t queueCapacity) : queue(queueCapacity) {};
+
+        SpscQueue<Task> queue;
+        // Written by the dispatching thread only.
+        std::uint64_t enqueued = 0;
+        std::uint64_t markerSequence = 0;
+        bool touched = false;
+        // Written by the shard thread only.
+        std::atomic<std::uint64_t> applied = 0;
+        std::atomic<std::int64_t> appliedLsn = 0;
+        std::jthread thread;
+    };
+
+    template <typename Tuple>
+    static events::TupleDataColumnView<Context::Binary> columnView(
+        const Tuple &tuple, std::size_t index) {
+        if constexpr (Context::TupleStorage == TupleStorageValue::PACKED) {
+            return tuple[index];
+        } else {
+            return events::viewTupleColumn<Context::Binary>(tuple[index]);
+        };
+    };
+
+    // Hashes the key columns of tuple, std::nullopt when one of them is
+    // missing or an unchanged TOAST value.
+    template <typename Tuple>
+    static std::optional<std::size_t> hashKey(
+        const events::RelationSchema &schema, const Tuple &tuple) {
+        auto hash = std::hash<std::int32_t>{}(schema.oid);
+        for (const auto &column : schema.keyColumns) {
+            if (column >= tuple.size()) return std::nullopt;
+            const auto &value = std::visit(
+                [](const auto &value) -> std::optional<std::size_t> {
+                    using T = std::decay_t<decltype(value)>;
+                    if constexpr (std::is_same_v<T, events::PGNull>) {
+                        return 0;
+                    } else if constexpr (std::is_same_v<
+                                             T,
+                                             events::PGUnchangedToastedValue>) {
+                        return std::nullopt;
+                    } else if constexpr (std::is_same_v<T, std::string_view>) {
+                        return std::hash<std::string_view>{}(value);
+                    } else {
+                        return std::hash<std::string_view>{}(std::string_view(
+                            reinterpret_cast<const char *>(value.data()),
+                            value.size()));
+                    };
+                },
+                columnView(tuple, column));
+            if (!value.has_value()) return std::nullopt;
+            hash ^= value.value() + 0x9e3779b97f4a7c15 + (hash << 6) +
+                    (hash >> 2);
+        };
+        return hash;
+    };
+
+    template <typename Tuple>
+    std::optional<std::size_t> shardOf(const events::RelationSchema &schema,
+                                       const Tuple &tuple) const {
+        const auto &hash = hashKey(schema, tuple);
+        if (!hash.has_value()) return std::nullopt;
+        return hash.value() % shards.size();
+    };
+
+    template <typename OldTuple>
+    std::optional<std::size_t> shardOfOld(
+        const events::RelationSchema &schema,
+        const OldTuple &oldDataOrPrimaryKey) const {
+        return std::visit(
+            [this, &schema](const auto &tuple) {
+                return shardOf(schema, tuple);
+            },
+            oldDataOrPrimaryKey);
+    };
+
+    std::optional<std::size_t> route(
+        const typename Context::events::Insert &insert) {
+        const auto &schema = relations.find(insert.oid);
+        if (!schema.has_value()) return std::nullopt;
+        return shardOf(schema.value(), insert.data);
+    };
+
+    std::optional<std::size_t> route(
+        const typename Context::events::Update &update) {
+        const auto &schema = relations.find(update.oid);
+        if (!schema.has_value()) return std::nullopt;
+        const auto &shard = shardOf(schema.value(), update.data);
+        if (!update.oldDataOrPrimaryKey.has_value()) return shard;
+        if (shard != shardOfOld(schema.value(),
+                                update.oldDataOrPrimaryKey.value())) {
+            return std::nullopt;
+        };
+        return shard;
+    };
+
+    std::optional<std::size_t> route(
+        const typename Context::events::Delete &remove) {
+        const auto &schema = relations.find(remove.oid);
+        if (!schema.has_value() || !remove.oldDataOrPrimaryKey.has_value()) {
+            return std::nullopt;
+        };
+        return shardOfOld(schema.value(), remove.oldDataOrPrimaryKey.value());
+    };
+
+    void dispatchRow(std::optional<std::size_t> shardIndex, Event &&event) {
+        if (!shardIndex.has_value()) {
+            waitIdle();
+            handler(event);
+            return;
+        };
+        auto &shard = *shards[shardIndex.value()];
+        shard.touched = true;
+        enqueue(shard, { .event = std::move(event) });
+    };
+
+    void enqueue(Shard &shard, Task &&task) {
+        shard.enqueued++;
+        shard.queue.push(std::move(task));
+    };
+
+    void run(Shard &shard) {
+        while (true) {
+            auto &task = shard.queue.waitFront();
+            if (task.kind == TaskKind::STOP) {
+                shard.queue.pop();
+                return;
+            };
+            if (task.kind == TaskKind::COMMIT) {
+                shard.appliedLsn.store(task.lsn, std::memory_order_release);
+            } else if (!failed.load(std::memory_order_acquire)) {
+                try {
+                    handler(task.event.value());
+                } catch (...) {
+                    std::lock_guard failureLock(failureMutex);
+                    if (!failure) failure = std::current_exception();
+                    failed.store(true, std::memory_order_release);
+                };
+            };
+            shard.queue.pop();
+            shard.applied.fetch_add(1, std::memory_order_release);
+            shard.applied.notify_all();
+        };
+    };
+
+    void waitIdle() {
+        for (auto &shard : shards) {
+            auto applied = shard->applied.load(std::memory_order_acquire);
+            while (applied != shard->enqueued) {
+                shard->applied.wait(applied, std::memory_order_acquire);
+                applied = shard->applied.load(std::memory_order_acquire);
+            };
+        };
+    };
+
+    void rethrowFailure() {
+        if (!failed.load(std::memory_order_acquire)) return;
+        std::lock_guard lock(failureMutex);
+        std::rethrow_exception(failure);
+    };
+
+    Handler handler;
+    std::vector<std::unique_ptr<Shard>> shards;
+    events::RelationCache relations;
+    std::int64_t commitLsn = 0;
+    std::int64_t watermark = 0;
+    std::atomic<bool> failed = false;
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
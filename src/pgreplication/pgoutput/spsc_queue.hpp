@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Bounded ring buffer between exactly one producer thread and one consumer
+// thread. Capacity is rounded up to a power of two. tryPush()/front()/pop()
+// never block or lock: each side only writes its own index and caches the
+// other side's index, so the shared cache lines are only touched when the
+// cached view says the ring is full or empty. push() and waitFront() spin
+// briefly and then sleep on the other side's index with std::atomic::wait.
+template <typename T>
+class SpscQueue {
+   public:
+    explicit SpscQueue(std::size_t capacity)
+        : slotCount(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+          slots(std::make_unique<Slot[]>(slotCount)) {};
+
+    ~SpscQueue() {
+        while (front() != nullptr) pop();
+    };
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Producer side. value is only moved from when true is returned.
+    bool tryPush(T &&value) {
+        const auto tail = producer.index.load(std::memory_order_relaxed);
+        if (tail - producer.cachedIndex == slotCount) {
+            producer.cachedIndex =
+                consumer.index.load(std::memory_order_acquire);
+            if (tail - producer.cachedIndex == slotCount) return false;
+        };
+        std::construct_at(slot(tail), std::move(value));
+        producer.index.store(tail + 1, std::memory_order_release);
+        producer.index.notify_one();
+        return true;
+    };
+
+    void push(T &&value) {
+        for (std::size_t attempt = 0; !tryPush(std::move(value)); attempt++) {
+            if (attempt < spinCount) continue;
+            const auto head = consumer.index.load(std::memory_order_acquire);
+            if (producer.index.load(std::memory_order_relaxed) - head ==
+                slotCount) {
+                consumer.index.wait(head, std::memory_order_acquire);
+            };
+        };
+    };
+
+    // Consumer side. The element stays in the ring until pop().
+    T *front() {
+        const auto head = consumer.index.load(std::memory_order_relaxed);
+        if (head == consumer.cachedIndex) {
+            consumer.cachedIndex =
+                producer.index.load(std::memory_order_acquire);
+            if (head == consumer.cachedIndex) return nullptr;
+        };
+        return slot(head);
+    };
+
+    T &waitFront() {
+        for (std::size_t attempt = 0;; attempt++) {
+            if (auto *value = front()) return *value;
+            if (attempt < spinCount) continue;
+            const auto tail = producer.index.load(std::memory_order_acquire);
+            if (tail == consumer.index.load(std::memory_order_relaxed)) {
+                producer.index.wait(tail, std::memory_order_acquire);
+            };
+        };
+    };
+
+    void pop() {
+        const auto head = consumer.index.load(std::memory_order_relaxed);
+        std::destroy_at(slot(head));
+        consumer.index.store(head + 1, std::memory_order_release);
+        consumer.index.notify_one();
+    };
+
+    // Number of queued elements, callable from any thread. It is only a
+    // snapshot and may be outdated by the time it is returned.
+    std::size_t size() const {
+        const auto head = consumer.index.load(std::memory_order_acquire);
+        return producer.index.load(std::memory_order_acquire) - head;
+    };
+    std::size_t capacity() const { return slotCount; };
+
+   private:
+    constexpr static std::size_t spinCount = 64;
+    constexpr static std::size_t cacheLineSize = 64;
+
+    struct Slot {
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    // Each side's index and its cached copy of the other side's index share
+    // a cache line that only that side writes.
+    struct alignas(cacheLineSize) Side {
+        std::atomic<std::uint64_t> index = 0;
+        std::uint64_t cachedIndex = 0;
+    };
+
+    T *slot(std::uint64_t index) {
+        return std::launder(
+            reinterpret_cast<T *>(slots[index & (slotCount - 1)].storage));
+    };
+
+    std::size_t slotCount;
+    std::unique_ptr<Slot[]> slots;
+    Side producer;
+    Side consumer;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
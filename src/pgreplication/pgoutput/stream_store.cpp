@@ -0,0 +1,177 @@
+#include "./stream_store.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+namespace {
+std::error_code lastError() {
+    return std::error_code(errno, std::system_category());
+};
+};  // namespace
+
+StreamedTransactionStore::StreamedTransactionStore(
+    std::filesystem::path directory, std::size_t memoryLimit)
+    : directory(std::move(directory)), memoryLimit(memoryLimit) {};
+
+StreamedTransactionStore::~StreamedTransactionStore() {
+    while (!transactions.empty()) discard(transactions.begin()->first);
+};
+
+StreamedTransactionStore::Mapping::~Mapping() {
+    if (address != nullptr) ::munmap(address, length);
+};
+
+std::filesystem::path StreamedTransactionStore::pathFor(
+    std::int32_t transactionId) const {
+    return directory /
+           std::format("{}.stream", static_cast<std::uint32_t>(transactionId));
+};
+
+std::expected<void, std::error_code> StreamedTransactionStore::append(
+    std::int32_t transactionId, std::int32_t subTransactionId,
+    std::span<const char> message) {
+    const auto &length = static_cast<std::uint32_t>(message.size());
+    const auto &recordSize = sizeof(length) + message.size();
+    // Make room before touching the transaction, so a failed spill leaves
+    // nothing of the message behind and the call can be retried.
+    while (memoryBytes + recordSize > memoryLimit && memoryBytes != 0) {
+        const auto &largest = std::ranges::max_element(
+            transactions, {}, [](const auto &entry) {
+                return entry.second.memory.size();
+            });
+        if (const auto &error = spill(largest->first, largest->second)) {
+            return std::unexpected(error);
+        };
+    };
+
+    auto &transaction = transactions[transactionId];
+    if (subTransactionId != transactionId &&
+        std::ranges::find(transaction.subTransactions, subTransactionId,
+                          &SubTransaction::id) ==
+            transaction.subTransactions.end()) {
+        transaction.subTransactions.push_back(
+            { .id = subTransactionId, .offset = transaction.size() });
+    };
+
+    auto &memory = transaction.memory;
+    const auto &position = memory.size();
+    memory.resize(position + recordSize);
+    std::memcpy(memory.data() + position, &length, sizeof(length));
+    std::memcpy(memory.data() + position + sizeof(length), message.data(),
+                message.size());
+    memoryBytes += recordSize;
+    return {};
+};
+
+std::error_code StreamedTransactionStore::spill(std::int32_t transactionId,
+                                                Transaction &transaction) {
+    if (transaction.fd == -1) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) return error;
+        transaction.fd =
+            ::open(pathFor(transactionId).c_str(),
+                   O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (transaction.fd == -1) return lastError();
+    };
+    std::size_t written = 0;
+    while (written < transaction.memory.size()) {
+        const auto &result =
+            ::pwrite(transaction.fd, transaction.memory.data() + written,
+                     transaction.memory.size() - written,
+                     static_cast<off_t>(transaction.fileSize + written));
+        if (result == -1) {
+            if (errno == EINTR) continue;
+            return lastError();
+        };
+        written += static_cast<std::size_t>(result);
+    };
+    transaction.fileSize += written;
+    fileBytes += written;
+    memoryBytes -= transaction.memory.size();
+    // Release the memory rather than only clearing it, otherwise spilling
+    // would not bound the resident size.
+    std::vector<char>().swap(transaction.memory);
+    return {};
+};
+
+std::expected<StreamedTransactionStore::Mapping, std::error_code>
+StreamedTransactionStore::map(const Transaction &transaction) const {
+    if (transaction.fileSize == 0) return Mapping();
+    // MAP_PRIVATE keeps the pages writable for in-place parsing without
+    // modifying the file.
+    auto *address = ::mmap(nullptr, transaction.fileSize,
+                           PROT_READ | PROT_WRITE, MAP_PRIVATE, transaction.fd,
+                           0);
+    if (address == MAP_FAILED) return std::unexpected(lastError());
+    ::madvise(address, transaction.fileSize, MADV_SEQUENTIAL);
+    return Mapping(static_cast<char *>(address), transaction.fileSize);
+};
+
+std::error_code StreamedTransactionStore::truncate(Transaction &transaction,
+                                                   std::uint64_t size) {
+    if (size >= transaction.fileSize) {
+        const auto &memorySize = size - transaction.fileSize;
+        memoryBytes -= transaction.memory.size() - memorySize;
+        transaction.memory.resize(memorySize);
+        return {};
+    };
+    if (::ftruncate(transaction.fd, static_cast<off_t>(size)) == -1) {
+        return lastError();
+    };
+    fileBytes -= transaction.fileSize - size;
+    transaction.fileSize = size;
+    memoryBytes -= transaction.memory.size();
+    transaction.memory.clear();
+    return {};
+};
+
+std::expected<void, std::error_code> StreamedTransactionStore::abort(
+    std::int32_t transactionId, std::int32_t subTransactionId) {
+    if (subTransactionId == transactionId) {
+        discard(transactionId);
+        return {};
+    };
+    const auto &it = transactions.find(transactionId);
+    if (it == transactions.end()) return {};
+    auto &subTransactions = it->second.subTransactions;
+    const auto &subTransaction = std::ranges::find(
+        subTransactions, subTransactionId, &SubTransaction::id);
+    if (subTransaction == subTransactions.end()) return {};
+    // Subtransactions that appeared later were nested in the aborted one
+    // or start after its data, both of which are cut off by the truncation.
+    if (const auto &error = truncate(it->second, subTransaction->offset)) {
+        return std::unexpected(error);
+    };
+    subTransactions.erase(subTransaction, subTransactions.end());
+    return {};
+};
+
+void StreamedTransactionStore::discard(std::int32_t transactionId) {
+    const auto &it = transactions.find(transactionId);
+    if (it == transactions.end()) return;
+    auto &transaction = it->second;
+    memoryBytes -= transaction.memory.size();
+    fileBytes -= transaction.fileSize;
+    if (transaction.fd != -1) {
+        ::close(transaction.fd);
+        ::unlink(pathFor(transactionId).c_str());
+    };
+    transactions.erase(it);
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "./events/stream.hpp"
+#include "./options.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+// Holds the raw messages of streamed in-progress transactions until their
+// StreamCommit or StreamAbort arrives. Every transaction keeps its most
+// recent messages in memory; before an append would take the total in
+// memory above memoryLimit, the largest in-memory tails are appended to
+// per-transaction files in directory, and replay() maps those files back
+// instead of reading them. A single message larger than memoryLimit stays
+// in memory until the next append.
+// Subtransaction aborts truncate both tiers back to the position at which
+// the subtransaction first appeared, matching how the apply worker of
+// PostgreSQL handles them. directory is only created once a transaction
+// first spills. System call failures are returned as std::error_code and
+// leave the stored messages as they were before the failing call, so a
+// failed append can be retried.
+class StreamedTransactionStore {
+   public:
+    constexpr static std::size_t defaultMemoryLimit = 64 * 1024 * 1024;
+
+    explicit StreamedTransactionStore(
+        std::filesystem::path directory,
+        std::size_t memoryLimit = defaultMemoryLimit);
+    ~StreamedTransactionStore();
+
+    StreamedTransactionStore(const StreamedTransactionStore &) = delete;
+    StreamedTransactionStore &operator=(const StreamedTransactionStore &) =
+        delete;
+
+    // subTransactionId is the xid carried by the change itself, which equals
+    // transactionId for changes of the top-level transaction.
+    std::expected<void, std::error_code> append(
+        std::int32_t transactionId, std::int32_t subTransactionId,
+        std::span<const char> message);
+
+    // Calls callback with every stored message of transactionId, in the
+    // order they were appended, then discards the transaction. The spans
+    // are writable so they can be handed to parseEvent directly, and stay
+    // valid only for the duration of the callback. If the spilled part
+    // cannot be mapped, nothing is replayed and the transaction is kept.
+    template <typename Callback>
+    std::expected<void, std::error_code> replay(std::int32_t transactionId,
+                                                Callback &&callback) {
+        const auto &it = transactions.find(transactionId);
+        if (it == transactions.end()) return {};
+        {
+            const auto &mapping = map(it->second);
+            if (!mapping.has_value()) {
+                return std::unexpected(mapping.error());
+            };
+            forEachMessage(mapping->data(), callback);
+            forEachMessage(std::span(it->second.memory), callback);
+        };
+        discard(transactionId);
+        return {};
+    };
+
+    std::expected<void, std::error_code> abort(std::int32_t transactionId,
+                                               std::int32_t subTransactionId);
+
+    template <StreamingValue Streaming>
+    std::expected<void, std::error_code> abort(
+        const events::StreamAbort<Streaming> &event) {
+        return abort(event.transactionId, event.subTransactionId);
+    };
+
+    void discard(std::int32_t transactionId);
+
+    bool contains(std::int32_t transactionId) const {
+        return transactions.contains(transactionId);
+    };
+    std::size_t size() const { return transactions.size(); };
+    std::size_t memoryUsage() const { return memoryBytes; };
+    std::size_t spilledBytes() const { return fileBytes; };
+
+   private:
+    struct SubTransaction {
+        std::int32_t id;
+        std::uint64_t offset;
+    };
+
+    struct Transaction {
+        int fd = -1;
+        std::uint64_t fileSize = 0;
+        std::vector<char> memory;
+        std::vector<SubTransaction> subTransactions;
+
+        std::uint64_t size() const { return fileSize + memory.size(); };
+    };
+
+    class Mapping {
+       public:
+        Mapping() = default;
+        Mapping(char *address, std::size_t length)
+            : address(address), length(length) {};
+        Mapping(Mapping &&other) noexcept
+            : address(std::exchange(other.address, nullptr)),
+              length(std::exchange(other.length, 0)) {};
+        Mapping(const Mapping &) = delete;
+        Mapping &operator=(const Mapping &) = delete;
+        ~Mapping();
+
+        std::span<char> data() const { return { address, length }; };
+
+       private:
+        char *address = nullptr;
+        std::size_t length = 0;
+    };
+
+    template <typename Callback>
+    static void forEachMessage(std::span<char> records, Callback &callback) {
+        std::size_t offset = 0;
+        while (offset + sizeof(std::uint32_t) <= records.size()) {
+            std::uint32_t length;
+            std::memcpy(&length, records.data() + offset, sizeof(length));
+            offset += sizeof(length);
+            callback(records.subspan(offset, length));
+            offset += length;
+        };
+    };
+
+    std::expected<Mapping, std::error_code> map(
+        const Transaction &transaction) const;
+    std::error_code spill(std::int32_t transactionId,
+                          Transaction &transaction);
+    std::error_code truncate(Transaction &transaction, std::uint64_t size);
+    std::filesystem::path pathFor(std::int32_t transactionId) const;
+
+    std::filesystem::path directory;
+    std::size_t memoryLimit;
+    std::size_t memoryBytes = 0;
+    std::size_t fileBytes = 0;
+    std::unordered_map<std::int32_t, Transaction> transactions;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,550 @@
+#include "./text_decoders.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PGREPLICATION_X86 1
+#endif
+
+#include "pgreplication/error.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+namespace {
+std::unexpected<ParseError> invalidValue(std::size_t offset) {
+    return std::unexpected(
+        ParseError{ .code = ParseErrorCode::INVALID_VALUE,
+                    .offset = static_cast<std::uint32_t>(offset) });
+};
+
+struct DateTimeFields {
+    int year;
+    unsigned month;
+    unsigned day;
+    int hour;
+    int minute;
+};
+
+// Kernels work on fixed size inputs so every SIMD load is in bounds:
+// digits takes 1 to 16 ASCII characters, dateTime exactly the 16 bytes of
+// "YYYY-MM-DD HH:MM" and hex 32 hex digits.
+struct Kernels {
+    bool (*digits)(const char *text, std::size_t length, std::uint64_t &value);
+    bool (*dateTime)(const char *text, DateTimeFields &fields);
+    bool (*hex)(const char *text, std::byte *out);
+};
+
+bool scalarDigits(const char *text, std::size_t length, std::uint64_t &value) {
+    value = 0;
+    for (std::size_t index = 0; index < length; index++) {
+        const auto &digit = static_cast<unsigned>(text[index] - '0');
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+    };
+    return true;
+};
+
+bool scalarTwoDigits(const char *text, int &value) {
+    std::uint64_t result;
+    if (!scalarDigits(text, 2, result)) return false;
+    value = static_cast<int>(result);
+    return true;
+};
+
+bool scalarDateTime(const char *text, DateTimeFields &fields) {
+    if (text[4] != '-' || text[7] != '-' || text[10] != ' ' ||
+        text[13] != ':') {
+        return false;
+    };
+    std::uint64_t year;
+    int month, day;
+    if (!scalarDigits(text, 4, year) || !scalarTwoDigits(text + 5, month) ||
+        !scalarTwoDigits(text + 8, day) ||
+        !scalarTwoDigits(text + 11, fields.hour) ||
+        !scalarTwoDigits(text + 14, fields.minute)) {
+        return false;
+    };
+    fields.year = static_cast<int>(year);
+    fields.month = static_cast<unsigned>(month);
+    fields.day = static_cast<unsigned>(day);
+    return true;
+};
+
+int hexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+};
+
+bool scalarHex(const char *text, std::byte *out) {
+    for (std::size_t index = 0; index < 16; index++) {
+        const auto &high = hexNibble(text[index * 2]);
+        const auto &low = hexNibble(text[index * 2 + 1]);
+        if (high < 0 || low < 0) return false;
+        out[index] = static_cast<std::byte>(high << 4 | low);
+    };
+    return true;
+};
+
+#ifdef PGREPLICATION_X86
+// All bytes of value are in [0, 9].
+__attribute__((target("sse4.2"))) bool allDigits(__m128i value) {
+    const auto &nine = _mm_set1_epi8(9);
+    return _mm_movemask_epi8(
+               _mm_cmpeq_epi8(_mm_max_epu8(value, nine), nine)) == 0xFFFF;
+};
+
+// Combines 16 digit values (most significant first) into 2 x 8 digits.
+__attribute__((target("sse4.2"))) std::uint64_t combineDigits(
+    __m128i digits) {
+    const auto &pairs = _mm_maddubs_epi16(
+        digits, _mm_set_epi8(1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10,
+                             1, 10));
+    const auto &quads =
+        _mm_madd_epi16(pairs, _mm_set_epi16(1, 100, 1, 100, 1, 100, 1, 100));
+    const auto &packed = _mm_packus_epi32(quads, quads);
+    const auto &octets = _mm_madd_epi16(
+        packed, _mm_set_epi16(1, 10000, 1, 10000, 1, 10000, 1, 10000));
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si32(octets)) * 100000000 +
+           static_cast<std::uint32_t>(_mm_extract_epi32(octets, 1));
+};
+
+__attribute__((target("sse4.2"))) bool sse42Digits(const char *text,
+                                                    std::size_t length,
+                                                    std::uint64_t &value) {
+    // Right align the digits behind leading zeros so the place values of
+    // the lanes are fixed.
+    alignas(16) char buffer[16];
+    std::memset(buffer, '0', sizeof(buffer));
+    std::memcpy(buffer + sizeof(buffer) - length, text, length);
+    const auto &digits = _mm_sub_epi8(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(buffer)),
+        _mm_set1_epi8('0'));
+    if (!allDigits(digits)) return false;
+    value = combineDigits(digits);
+    return true;
+};
+
+__attribute__((target("sse4.2"))) bool sse42DateTime(const char *text,
+                                                      DateTimeFields &fields) {
+    const auto &value =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+    const auto &separators = _mm_setr_epi8(0, 0, 0, 0, '-', 0, 0, '-', 0, 0,
+                                           ' ', 0, 0, ':', 0, 0);
+    constexpr int separatorMask = 1 << 4 | 1 << 7 | 1 << 10 | 1 << 13;
+    if ((_mm_movemask_epi8(_mm_cmpeq_epi8(value, separators)) &
+         separatorMask) != separatorMask) {
+        return false;
+    };
+    // Gather the twelve digits into adjacent pairs, zeroing the rest.
+    const auto &digits = _mm_shuffle_epi8(
+        _mm_sub_epi8(value, _mm_set1_epi8('0')),
+        _mm_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, -1, -1, -1,
+                      -1));
+    if (!allDigits(digits)) return false;
+    const auto &pairs = _mm_maddubs_epi16(
+        digits, _mm_set_epi8(1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10,
+                             1, 10));
+    fields.year =
+        _mm_extract_epi16(pairs, 0) * 100 + _mm_extract_epi16(pairs, 1);
+    fields.month = static_cast<unsigned>(_mm_extract_epi16(pairs, 2));
+    fields.day = static_cast<unsigned>(_mm_extract_epi16(pairs, 3));
+    fields.hour = _mm_extract_epi16(pairs, 4);
+    fields.minute = _mm_extract_epi16(pairs, 5);
+    return true;
+};
+
+__attribute__((target("sse4.2"))) bool sse42Hex16(const char *text,
+                                                   std::byte *out) {
+    const auto &value =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+    const auto &lower = _mm_or_si128(value, _mm_set1_epi8(0x20));
+    const auto &isDigit =
+        _mm_and_si128(_mm_cmpgt_epi8(value, _mm_set1_epi8('0' - 1)),
+                      _mm_cmplt_epi8(value, _mm_set1_epi8('9' + 1)));
+    const auto &isLetter =
+        _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                      _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF) {
+        return false;
+    };
+    const auto &nibbles =
+        _mm_blendv_epi8(_mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)),
+                        _mm_sub_epi8(value, _mm_set1_epi8('0')), isDigit);
+    const auto &bytes = _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out),
+                     _mm_packus_epi16(bytes, bytes));
+    return true;
+};
+
+__attribute__((target("sse4.2"))) bool sse42Hex(const char *text,
+                                                 std::byte *out) {
+    return sse42Hex16(text, out) && sse42Hex16(text + 16, out + 8);
+};
+
+__attribute__((target("avx2"))) bool avx2Hex(const char *text,
+                                              std::byte *out) {
+    const auto &value =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text));
+    const auto &lower = _mm256_or_si256(value, _mm256_set1_epi8(0x20));
+    const auto &isDigit =
+        _mm256_and_si256(_mm256_cmpgt_epi8(value, _mm256_set1_epi8('0' - 1)),
+                         _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), value));
+    const auto &isLetter =
+        _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                         _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+    const auto &valid =
+        _mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) == -1;
+    const auto &nibbles = _mm256_blendv_epi8(
+        _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)),
+        _mm256_sub_epi8(value, _mm256_set1_epi8('0')), isDigit);
+    const auto &bytes =
+        _mm256_maddubs_epi16(nibbles, _mm256_set1_epi16(0x0110));
+    // packus works per 128 bit lane; move both low halves together.
+    const auto &packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(bytes, bytes), 0b10001000);
+    if (valid) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                         _mm256_castsi256_si128(packed));
+    };
+    // The callers are compiled for SSE; clear the upper halves explicitly
+    // to avoid the transition penalty rather than rely on the compiler.
+    _mm256_zeroupper();
+    return valid;
+};
+#endif
+
+constexpr std::array<Kernels, 3> kernelTable = {
+    Kernels{ scalarDigits, scalarDateTime, scalarHex },
+#ifdef PGREPLICATION_X86
+    Kernels{ sse42Digits, sse42DateTime, sse42Hex },
+    Kernels{ sse42Digits, sse42DateTime, avx2Hex },
+#else
+    Kernels{ scalarDigits, scalarDateTime, scalarHex },
+    Kernels{ scalarDigits, scalarDateTime, scalarHex },
+#endif
+};
+
+SimdLevel detectSimdLevel() {
+#ifdef PGREPLICATION_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return SimdLevel::SSE42;
+#endif
+    return SimdLevel::SCALAR;
+};
+
+// Function-local statics, so decoders used by other static initializers
+// still see the detected level.
+SimdLevel supportedLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+};
+
+std::atomic<SimdLevel> &activeLevel() {
+    static std::atomic<SimdLevel> level = supportedLevel();
+    return level;
+};
+
+const Kernels &kernels() {
+    return kernelTable[static_cast<std::size_t>(
+        activeLevel().load(std::memory_order_relaxed))];
+};
+
+template <typename T>
+std::expected<T, ParseError> decodeInteger(std::string_view text) {
+    const auto &negative = !text.empty() && text.front() == '-';
+    const auto &digits = text.substr(negative ? 1 : 0);
+    if (digits.empty()) return invalidValue(0);
+    if (digits.size() > 16) {
+        std::int64_t value;
+        const auto &[end, error] =
+            std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size()) {
+            return invalidValue(end - text.data());
+        };
+        if (value < std::numeric_limits<T>::min() ||
+            value > std::numeric_limits<T>::max()) {
+            return invalidValue(0);
+        };
+        return static_cast<T>(value);
+    };
+    std::uint64_t magnitude;
+    if (!kernels().digits(digits.data(), digits.size(), magnitude)) {
+        return invalidValue(negative ? 1 : 0);
+    };
+    const auto &value = negative ? -static_cast<std::int64_t>(magnitude)
+                                 : static_cast<std::int64_t>(magnitude);
+    if (value < std::numeric_limits<T>::min() ||
+        value > std::numeric_limits<T>::max()) {
+        return invalidValue(0);
+    };
+    return static_cast<T>(value);
+};
+
+template <typename T>
+std::expected<T, ParseError> decodeFloat(std::string_view text) {
+    T value;
+    const auto &[end, error] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size()) {
+        return invalidValue(end - text.data());
+    };
+    return value;
+};
+
+// Parses the "YYYY-MM-DD HH:MM" prefix, years beyond four digits included,
+// and returns how many characters it used.
+std::size_t parseDateTimePrefix(std::string_view text,
+                                DateTimeFields &fields) {
+    const auto &yearLength = text.find('-');
+    if (yearLength < 4 || yearLength == std::string_view::npos ||
+        text.size() < yearLength + 12) {
+        return 0;
+    };
+    if (yearLength == 4) {
+        return kernels().dateTime(text.data(), fields) ? 16 : 0;
+    };
+    std::uint64_t year;
+    if (yearLength > 9 || !scalarDigits(text.data(), yearLength, year)) {
+        return 0;
+    };
+    char buffer[16] = { '0', '0', '0', '0' };
+    std::memcpy(buffer + 4, text.data() + yearLength, 12);
+    if (!kernels().dateTime(buffer, fields)) return 0;
+    fields.year = static_cast<int>(year);
+    return yearLength + 12;
+};
+
+bool stripEra(std::string_view &text) {
+    if (!text.ends_with(" BC")) return false;
+    text.remove_suffix(3);
+    return true;
+};
+
+std::optional<std::chrono::sys_days> toDays(const DateTimeFields &fields,
+                                            bool beforeChrist) {
+    const auto &date = std::chrono::year_month_day(
+        std::chrono::year(beforeChrist ? 1 - fields.year : fields.year),
+        std::chrono::month(fields.month), std::chrono::day(fields.day));
+    if (!date.ok()) return std::nullopt;
+    return std::chrono::sys_days(date);
+};
+};  // namespace
+
+SimdLevel textDecoderSimdLevel() {
+    return activeLevel().load(std::memory_order_relaxed);
+};
+
+void setTextDecoderSimdLevel(SimdLevel level) {
+    activeLevel().store(std::min(level, supportedLevel()),
+                        std::memory_order_relaxed);
+};
+
+template <>
+std::expected<bool, ParseError> decodeText<bool>(std::string_view text) {
+    if (text == "t" || text == "true") return true;
+    if (text == "f" || text == "false") return false;
+    return invalidValue(0);
+};
+
+template <>
+std::expected<std::int16_t, ParseError> decodeText<std::int16_t>(
+    std::string_view text) {
+    return decodeInteger<std::int16_t>(text);
+};
+
+template <>
+std::expected<std::int32_t, ParseError> decodeText<std::int32_t>(
+    std::string_view text) {
+    return decodeInteger<std::int32_t>(text);
+};
+
+template <>
+std::expected<std::int64_t, ParseError> decodeText<std::int64_t>(
+    std::string_view text) {
+    return decodeInteger<std::int64_t>(text);
+};
+
+template <>
+std::expected<float, ParseError> decodeText<float>(std::string_view text) {
+    return decodeFloat<float>(text);
+};
+
+template <>
+std::expected<double, ParseError> decodeText<double>(std::string_view text) {
+    return decodeFloat<double>(text);
+};
+
+template <>
+std::expected<Date, ParseError> decodeText<Date>(std::string_view text) {
+    if (text == "infinity") return Date::max();
+    if (text == "-infinity") return Date::min();
+    const auto &beforeChrist = stripEra(text);
+    // Pad to the date time layout so the same kernel applies.
+    char buffer[32];
+    if (text.size() + 6 > sizeof(buffer)) return invalidValue(0);
+    std::memcpy(buffer, text.data(), text.size());
+    std::memcpy(buffer + text.size(), " 00:00", 6);
+    DateTimeFields fields;
+    const auto &used = parseDateTimePrefix(
+        std::string_view(buffer, text.size() + 6), fields);
+    if (used != text.size() + 6) return invalidValue(0);
+    const auto &days = toDays(fields, beforeChrist);
+    if (!days.has_value()) return invalidValue(0);
+    return days.value();
+};
+
+template <>
+std::expected<Timestamp, ParseError> decodeText<Timestamp>(
+    std::string_view text) {
+    if (text == "infinity") return Timestamp::max();
+    if (text == "-infinity") return Timestamp::min();
+    const auto &beforeChrist = stripEra(text);
+    DateTimeFields fields;
+    auto position = parseDateTimePrefix(text, fields);
+    int second;
+    if (position == 0 || text.size() < position + 3 ||
+        text[position] != ':' ||
+        !scalarTwoDigits(text.data() + position + 1, second) ||
+        fields.hour > 24 || fields.minute > 59 || second > 60) {
+        return invalidValue(position);
+    };
+    position += 3;
+
+    std::int64_t microseconds = 0;
+    if (position < text.size() && text[position] == '.') {
+        position++;
+        std::size_t digits = 0;
+        while (position < text.size() && digits < 6 &&
+               static_cast<unsigned>(text[position] - '0') <= 9) {
+            microseconds = microseconds * 10 + (text[position] - '0');
+            position++;
+            digits++;
+        };
+        if (digits == 0) return invalidValue(position);
+        for (; digits < 6; digits++) microseconds *= 10;
+    };
+
+    std::chrono::seconds offset{ 0 };
+    if (position < text.size()) {
+        const auto &sign = text[position];
+        if (sign != '+' && sign != '-') return invalidValue(position);
+        position++;
+        int parts[3] = { 0, 0, 0 };
+        for (std::size_t part = 0; part < 3 && position < text.size();
+             part++) {
+            if (part > 0) {
+                if (text[position] != ':') return invalidValue(position);
+                position++;
+            };
+            if (text.size() < position + 2 ||
+                !scalarTwoDigits(text.data() + position, parts[part])) {
+                return invalidValue(position);
+            };
+            position += 2;
+        };
+        if (position != text.size()) return invalidValue(position);
+        offset = std::chrono::hours(parts[0]) +
+                 std::chrono::minutes(parts[1]) +
+                 std::chrono::seconds(parts[2]);
+        if (sign == '-') offset = -offset;
+    };
+
+    const auto &days = toDays(fields, beforeChrist);
+    if (!days.has_value()) return invalidValue(0);
+    return Timestamp(days.value()) + std::chrono::hours(fields.hour) +
+           std::chrono::minutes(fields.minute) +
+           std::chrono::seconds(second) +
+           std::chrono::microseconds(microseconds) - offset;
+};
+
+template <>
+std::expected<Uuid, ParseError> decodeText<Uuid>(std::string_view text) {
+    if (text.size() != 36 || text[8] != '-' || text[13] != '-' ||
+        text[18] != '-' || text[23] != '-') {
+        return invalidValue(0);
+    };
+    char hex[32];
+    std::memcpy(hex, text.data(), 8);
+    std::memcpy(hex + 8, text.data() + 9, 4);
+    std::memcpy(hex + 12, text.data() + 14, 4);
+    std::memcpy(hex + 16, text.data() + 19, 4);
+    std::memcpy(hex + 20, text.data() + 24, 12);
+    Uuid value;
+    if (!kernels().hex(hex, value.data())) return invalidValue(0);
+    return value;
+};
+
+namespace {
+template <typename T>
+std::expected<DecodedValue, ParseError> decodeTextAs(std::string_view text) {
+    return decodeText<T>(text).transform(
+        [](T value) { return DecodedValue(std::move(value)); });
+};
+};  // namespace
+
+std::expected<DecodedValue, ParseError> decodeText(std::int32_t oid,
+                                                   std::string_view text) {
+    switch (static_cast<TypeOid>(oid)) {
+        case TypeOid::BOOL:
+            return decodeTextAs<bool>(text);
+        case TypeOid::INT2:
+            return decodeTextAs<std::int16_t>(text);
+        case TypeOid::INT4:
+            return decodeTextAs<std::int32_t>(text);
+        case TypeOid::OID:
+            // Oids are unsigned; keep the bit pattern like the binary path.
+            return decodeText<std::int64_t>(text).transform(
+                [](std::int64_t value) {
+                    return DecodedValue(static_cast<std::int32_t>(value));
+                });
+        case TypeOid::INT8:
+            return decodeTextAs<std::int64_t>(text);
+        case TypeOid::FLOAT4:
+            return decodeTextAs<float>(text);
+        case TypeOid::FLOAT8:
+            return decodeTextAs<double>(text);
+        case TypeOid::DATE:
+            return decodeTextAs<Date>(text);
+        case TypeOid::TIMESTAMP:
+        case TypeOid::TIMESTAMPTZ:
+            return decodeTextAs<Timestamp>(text);
+        case TypeOid::UUID:
+            return decodeTextAs<Uuid>(text);
+        default:
+            return text;
+    };
+};
+
+std::expected<DecodedValue, ParseError> decodeTextColumn(
+    std::int32_t oid,
+    const events::TupleDataColumnView<BinaryValue::OFF> &column) {
+    return std::visit(
+        [oid](const auto &value) -> std::expected<DecodedValue, ParseError> {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, std::string_view>) {
+                return decodeText(oid, value);
+            } else {
+                return value;
+            };
+        },
+        column);
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <string_view>
+
+#include "./binary_decoders.hpp"
+#include "./events/base/tuple_data.hpp"
+#include "./options.hpp"
+#include "pgreplication/error.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+enum class SimdLevel { SCALAR, SSE42, AVX2 };
+
+// The level picked from the running CPU on first use. Setting it is meant
+// for tests and benchmarks; a level the CPU does not support is clamped.
+SimdLevel textDecoderSimdLevel();
+void setTextDecoderSimdLevel(SimdLevel level);
+
+// Decoders for text mode column values as PostgreSQL prints them with
+// DateStyle ISO. They parse the column bytes in place and produce the same
+// types as the binary decoders. Integers up to 16 digits, the date/time
+// fields of dates and timestamps and the hex digits of uuids are converted
+// with SSE4.2 or AVX2 when available; floats go through std::from_chars,
+// whose Eisel-Lemire implementation is already faster than a SIMD split.
+template <typename T>
+std::expected<T, ParseError> decodeText(std::string_view text);
+
+template <>
+std::expected<bool, ParseError> decodeText<bool>(std::string_view text);
+template <>
+std::expected<std::int16_t, ParseError> decodeText<std::int16_t>(
+    std::string_view text);
+template <>
+std::expected<std::int32_t, ParseError> decodeText<std::int32_t>(
+    std::string_view text);
+template <>
+std::expected<std::int64_t, ParseError> decodeText<std::int64_t>(
+    std::string_view text);
+template <>
+std::expected<float, ParseError> decodeText<float>(std::string_view text);
+template <>
+std::expected<double, ParseError> decodeText<double>(std::string_view text);
+template <>
+std::expected<Date, ParseError> decodeText<Date>(std::string_view text);
+// Accepts both timestamp and timestamptz output; a trailing UTC offset is
+// applied so the result is always UTC.
+template <>
+std::expected<Timestamp, ParseError> decodeText<Timestamp>(
+    std::string_view text);
+template <>
+std::expected<Uuid, ParseError> decodeText<Uuid>(std::string_view text);
+
+// Dispatches on the column type oid like decodeBinary; types without a
+// text decoder are returned as the string_view itself.
+std::expected<DecodedValue, ParseError> decodeText(std::int32_t oid,
+                                                   std::string_view text);
+
+std::expected<DecodedValue, ParseError> decodeTextColumn(
+    std::int32_t oid,
+    const events::TupleDataColumnView<BinaryValue::OFF> &column);
+
+inline std::expected<DecodedValue, ParseError> decodeTextColumn(
+    std::int32_t oid,
+    const events::TupleDataColumn<BinaryValue::OFF> &column) {
+    return decodeTextColumn(
+        oid, events::viewTupleColumn<BinaryValue::OFF>(column));
+};
+
+inline std::expected<DecodedValue, ParseError> decodeTextColumn(
+    std::int32_t oid,
+    const events::ArenaTupleDataColumn<BinaryValue::OFF> &column) {
+    return decodeTextColumn(
+        oid, events::viewTupleColumn<BinaryValue::OFF>(column));
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
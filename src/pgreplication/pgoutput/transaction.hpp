@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "pgreplication/error.hpp"
+#include "pgreplication/pgoutput/events/base/begin.hpp"
+#include "pgreplication/pgoutput/events/base/commit.hpp"
+#include "pgreplication/pgoutput/events/base/event.hpp"
+#include "pgreplication/pgoutput/events/message.hpp"
+#include "pgreplication/pgoutput/events/origin.hpp"
+#include "pgreplication/pgoutput/events/stream.hpp"
+#include "pgreplication/pgoutput/events/stream_and_twophase.hpp"
+#include "pgreplication/pgoutput/events/twophase.hpp"
+
+namespace PGREPLICATION_NAMESPACE::pgoutput {
+template <typename Context>
+struct Transaction {
+    events::Begin begin;
+    events::Commit commit;
+    std::vector<typename Context::Event> changes;
+
+    std::int32_t transactionId() const { return begin.transactionId; };
+    std::int64_t finalLsn() const { return begin.finalTransactionLsn; };
+    std::int64_t endLsn() const { return commit.endLsn; };
+};
+
+// Collects everything between Begin and Commit into a Transaction whose
+// change vector is reused, so once it has grown to the largest transaction
+// seen, assembling does not allocate (tuple payloads still follow the
+// session's TupleStorage; combine with TransactionArena, whose lifetime rule
+// matches, to avoid those allocations too). The transaction returned on
+// Commit stays valid until the next push.
+//
+// Events outside a transaction (non-transactional messages, streamed blocks,
+// two-phase transactions) are rejected with UNEXPECTED_EVENT; check
+// inTransaction() first to route them elsewhere.
+template <typename Context>
+class TransactionAssembler {
+   public:
+    using Event = typename Context::Event;
+
+    explicit TransactionAssembler(std::size_t reserveChanges = 1024) {
+        transaction.changes.reserve(reserveChanges);
+    };
+
+    std::expected<const Transaction<Context> *, ParseError> push(
+        Event &&event) {
+        if (std::holds_alternative<events::Begin>(event)) {
+            if (open) {
+                return unexpectedEvent(
+                    static_cast<char>(events::BaseEventType::BEGIN));
+            };
+            transaction.begin = std::get<events::Begin>(event);
+            transaction.changes.clear();
+            open = true;
+            return nullptr;
+        };
+        if (!open) return unexpectedEvent(eventTypeOf(event));
+        if (std::holds_alternative<events::Commit>(event)) {
+            transaction.commit = std::get<events::Commit>(event);
+            open = false;
+            committedLsn = transaction.commit.endLsn;
+            return &transaction;
+        };
+        if (isStreamOrTwoPhase(event)) {
+            return unexpectedEvent(eventTypeOf(event));
+        };
+        transaction.changes.emplace_back(std::move(event));
+        return nullptr;
+    };
+
+    bool inTransaction() const { return open; };
+    std::size_t pendingChanges() const {
+        return open ? transaction.changes.size() : 0;
+    };
+    std::int64_t lastCommittedEndLsn() const { return committedLsn; };
+
+    void reset() {
+        transaction.changes.clear();
+        open = false;
+    };
+
+   private:
+    static std::unexpected<ParseError> unexpectedEvent(char eventType) {
+        return std::unexpected(ParseError{
+            .code = ParseErrorCode::UNEXPECTED_EVENT, .eventType = eventType });
+    };
+
+    static char eventTypeOf(const Event &event) {
+        return std::visit(
+            [](const auto &value) -> char {
+                using T = std::decay_t<decltype(value)>;
+                using E = typename Context::events;
+                using enum events::BaseEventType;
+                using enum events::MessagesEventType;
+                using enum events::OriginEventType;
+                using enum events::StreamingEventType;
+                using enum events::TwoPhaseCommitEventType;
+                using enum events::StreamingAndTwoPhaseCommitEventType;
+                if constexpr (std::is_same_v<T, typename E::Begin>)
+                    return static_cast<char>(BEGIN);
+                if constexpr (std::is_same_v<T, typename E::Commit>)
+                    return static_cast<char>(COMMIT);
+                if constexpr (std::is_same_v<T, typename E::Relation>)
+                    return static_cast<char>(RELATION);
+                if constexpr (std::is_same_v<T, typename E::Type>)
+                    return static_cast<char>(TYPE);
+                if constexpr (std::is_same_v<T, typename E::Insert>)
+                    return static_cast<char>(INSERT);
+                if constexpr (std::is_same_v<T, typename E::Update>)
+                    return static_cast<char>(UPDATE);
+                if constexpr (std::is_same_v<T, typename E::Delete>)
+                    return static_cast<char>(DELETE);
+                if constexpr (std::is_same_v<T, typename E::Truncate>)
+                    return static_cast<char>(TRUNCATE);
+                if constexpr (std::is_same_v<T, typename E::Message>)
+                    return static_cast<char>(MESSAGE);
+                if constexpr (std::is_same_v<T, typename E::Origin>)
+                    return static_cast<char>(ORIGIN);
+                if constexpr (std::is_same_v<T, typename E::StreamStart>)
+                    return static_cast<char>(STREAM_START);
+                if constexpr (std::is_same_v<T, typename E::StreamStop>)
+                    return static_cast<char>(STREAM_STOP);
+                if constexpr (std::is_same_v<T, typename E::StreamCommit>)
+                    return static_cast<char>(STREAM_COMMIT);
+                if constexpr (std::is_same_v<T, typename E::StreamAbort>)
+                    return static_cast<char>(STREAM_ABORT);
+                if constexpr (std::is_same_v<T, typename E::BeginPrepare>)
+                    return static_cast<char>(BEGIN_PREPARE);
+                if constexpr (std::is_same_v<T, typename E::Prepare>)
+                    return static_cast<char>(PREPARE);
+                if constexpr (std::is_same_v<T, typename E::CommitPrepared>)
+                    return static_cast<char>(COMMIT_PREPARED);
+                if constexpr (std::is_same_v<T, typename E::RollbackPrepared>)
+                    return static_cast<char>(ROLLBACK_PREPARED);
+                if constexpr (std::is_same_v<T, typename E::StreamPrepare>)
+                    return static_cast<char>(STREAM_PREPARE);
+                return '\0';
+            },
+            event);
+    };
+
+    static bool isStreamOrTwoPhase(const Event &event) {
+        using enum events::StreamingEventType;
+        using enum events::TwoPhaseCommitEventType;
+        using enum events::StreamingAndTwoPhaseCommitEventType;
+        switch (eventTypeOf(event)) {
+            case static_cast<char>(STREAM_START):
+            case static_cast<char>(STREAM_STOP):
+            case static_cast<char>(STREAM_COMMIT):
+            case static_cast<char>(STREAM_ABORT):
+            case static_cast<char>(BEGIN_PREPARE):
+            case static_cast<char>(PREPARE):
+            case static_cast<char>(COMMIT_PREPARED):
+            case static_cast<char>(ROLLBACK_PREPARED):
+            case static_cast<char>(STREAM_PREPARE):
+                return true;
+            default:
+                return false;
+        };
+    };
+
+    Transaction<Context> transaction;
+    bool open = false;
+    std::int64_t committedLsn = 0;
+};
+};  // namespace PGREPLICATION_NAMESPACE::pgoutput
@@ -0,0 +1,73 @@
+#include "../pgoutput/arena.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(TransactionArena, TestEventsAllocatedUntilNextParseAfterCommit) {
+    TransactionArena<ArenaTextContext> arena(1024);
+    auto insertBuffer = buildInsert(16384);
+    const auto &insertResult = arena.parseEvent(insertBuffer);
+    ASSERT_TRUE(insertResult.has_value()) << insertResult.error().message();
+    const auto &insert =
+        std::get<ArenaTextContext::events::Insert>(insertResult.value());
+    EXPECT_EQ(insert.data.get_allocator().resource(), arena.resource());
+    const auto &value = std::get<std::pmr::string>(insert.data[2]);
+    EXPECT_EQ(value, "hello");
+    EXPECT_EQ(value.get_allocator().resource(), arena.resource());
+
+    const auto &owned = insert.materialize();
+    EXPECT_EQ(std::get<std::string>(owned.data[2]), "hello");
+
+    auto commitBuffer = buildCommit(100);
+    const auto &commitResult = arena.parseEvent(commitBuffer);
+    ASSERT_TRUE(commitResult.has_value()) << commitResult.error().message();
+    EXPECT_EQ(
+        std::get<ArenaTextContext::events::Commit>(commitResult.value()).lsn,
+        100);
+    EXPECT_EQ(value, "hello");
+
+    const auto &nextResult = arena.parseEvent(insertBuffer);
+    ASSERT_TRUE(nextResult.has_value()) << nextResult.error().message();
+    EXPECT_EQ(std::get<std::string>(owned.data[2]), "hello");
+}
+
+TEST(TransactionArena, TestReleasesAfterStreamSegments) {
+    TransactionArena<StreamingArenaTextContext> arena(1024);
+    std::vector<char> streamStart = { 'S' };
+    appendInt32(streamStart, 7);
+    streamStart.push_back(1);
+    const auto &insert = buildInsert(16384);
+    std::vector<char> streamedInsert = { 'I' };
+    appendInt32(streamedInsert, 7);
+    streamedInsert.insert(streamedInsert.end(), insert.begin() + 1,
+                          insert.end());
+    std::vector<char> streamStop = { 'E' };
+
+    const auto &parseInsertData = [&arena, &streamedInsert]() {
+        const auto &result = arena.parseEvent(streamedInsert);
+        EXPECT_TRUE(result.has_value()) << result.error().message();
+        return static_cast<const void *>(
+            std::get<StreamingArenaTextContext::events::Insert>(result.value())
+                .data.data());
+    };
+    ASSERT_TRUE(arena.parseEvent(streamStart).has_value());
+    const auto *first = parseInsertData();
+    const auto *second = parseInsertData();
+    EXPECT_NE(first, second);
+    ASSERT_TRUE(arena.parseEvent(streamStop).has_value());
+    // The segment ended, so the next parse starts over at the front.
+    ASSERT_TRUE(arena.parseEvent(streamStart).has_value());
+    EXPECT_EQ(parseInsertData(), first);
+}
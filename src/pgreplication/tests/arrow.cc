@@ -0,0 +1,88 @@
+#include "../pgoutput/arrow.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(ColumnarAccumulator, TestExportsArrowArrays) {
+    const std::vector<events::CachedRelationColumn> columns = {
+        { .flags = 1, .name = "id", .oid = 23, .typeModifier = -1 },
+        { .flags = 0, .name = "name", .oid = 25, .typeModifier = -1 },
+    };
+    const events::RelationSchema schema = { .oid = 16384,
+                                            .relationNamespace = "public",
+                                            .name = "users",
+                                            .replicaIdentity = 'd',
+                                            .columns = columns };
+    ColumnarAccumulator accumulator(schema, BinaryValue::OFF, 4);
+    for (const auto &[id, name] : { std::pair{ "1", "ab" },
+                                    std::pair{ "2", "c" } }) {
+        std::vector<char> buffer = { 'I' };
+        appendInt32(buffer, 16384);
+        buffer.push_back('N');
+        appendInt16(buffer, 2);
+        appendTextColumn(buffer, id);
+        appendTextColumn(buffer, name);
+        const auto &event = BorrowedTextContext::parseEvent(buffer);
+        ASSERT_TRUE(event.has_value()) << event.error().message();
+        ASSERT_TRUE(accumulator
+                        .append(std::get<BorrowedTextContext::events::Insert>(
+                            event.value()))
+                        .has_value());
+    };
+
+    const auto *values = accumulator.columnBuffers()[0].values.data();
+    auto batch = accumulator.take();
+    EXPECT_EQ(accumulator.size(), 0);
+    EXPECT_EQ(batch.size, 2);
+    EXPECT_EQ(batch.relationName, "users");
+
+    ArrowSchema arrowSchema;
+    exportArrowSchema(batch, &arrowSchema);
+    EXPECT_STREQ(arrowSchema.format, "+s");
+    EXPECT_STREQ(arrowSchema.name, "users");
+    ASSERT_EQ(arrowSchema.n_children, 3);
+    EXPECT_STREQ(arrowSchema.children[0]->format, "C");
+    EXPECT_STREQ(arrowSchema.children[1]->format, "i");
+    EXPECT_STREQ(arrowSchema.children[2]->format, "u");
+    EXPECT_STREQ(arrowSchema.children[2]->name, "name");
+    EXPECT_EQ(arrowSchema.children[2]->flags, ARROW_FLAG_NULLABLE);
+
+    ArrowArray array;
+    exportArrowArray(std::move(batch), &array);
+    EXPECT_EQ(array.length, 2);
+    ASSERT_EQ(array.n_children, 3);
+    EXPECT_EQ(static_cast<const char *>(array.children[0]->buffers[1])[1],
+              'I');
+    EXPECT_EQ(array.children[1]->buffers[1], values);
+    EXPECT_EQ(array.children[1]->buffers[0], nullptr);
+    ASSERT_EQ(array.children[2]->n_buffers, 3);
+    EXPECT_EQ(static_cast<const std::int32_t *>(
+                  array.children[2]->buffers[1])[2],
+              3);
+
+    // Children moved out of the parent outlive its release.
+    ArrowArray child = *array.children[2];
+    array.children[2]->release = nullptr;
+    array.release(&array);
+    EXPECT_EQ(array.release, nullptr);
+    EXPECT_EQ(std::string_view(
+                  static_cast<const char *>(child.buffers[2]), 3),
+              "abc");
+    child.release(&child);
+    arrowSchema.release(&arrowSchema);
+    EXPECT_EQ(arrowSchema.release, nullptr);
+}
@@ -0,0 +1,137 @@
+#include "../pgoutput/binary_decoders.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+
+namespace {
+void appendBigEndian(std::vector<std::byte> &buffer, std::uint64_t value,
+                     std::size_t size) {
+    for (std::size_t index = size; index > 0; index--) {
+        buffer.push_back(static_cast<std::byte>(value >> ((index - 1) * 8)));
+    };
+};
+
+std::vector<std::byte> buildNumeric(
+    std::int16_t weight, std::uint16_t sign, std::int16_t scale,
+    std::initializer_list<std::int16_t> digits) {
+    std::vector<std::byte> buffer;
+    appendBigEndian(buffer, digits.size(), 2);
+    appendBigEndian(buffer, static_cast<std::uint16_t>(weight), 2);
+    appendBigEndian(buffer, sign, 2);
+    appendBigEndian(buffer, static_cast<std::uint16_t>(scale), 2);
+    for (const auto &digit : digits) appendBigEndian(buffer, digit, 2);
+    return buffer;
+};
+};  // namespace
+
+TEST(BinaryDecoders, TestFixedWidthTypes) {
+    std::vector<std::byte> buffer;
+    appendBigEndian(buffer, static_cast<std::uint32_t>(-42), 4);
+    const auto &int4 = decodeBinary(23, buffer);
+    ASSERT_TRUE(int4.has_value()) << int4.error().message();
+    EXPECT_EQ(std::get<std::int32_t>(int4.value()), -42);
+
+    const auto &mismatch = decodeBinary(20, buffer);
+    ASSERT_FALSE(mismatch.has_value());
+    EXPECT_EQ(mismatch.error().code, ParseErrorCode::BUFFER_SIZE_MISMATCH);
+
+    buffer.clear();
+    appendBigEndian(buffer, std::bit_cast<std::uint64_t>(2.5), 8);
+    EXPECT_EQ(decodeBinary<double>(buffer).value(), 2.5);
+
+    buffer.clear();
+    appendBigEndian(buffer, 86400LL * 1000000 + 1, 8);
+    const auto &timestamp = decodeBinary<Timestamp>(buffer).value();
+    EXPECT_EQ(timestamp, Timestamp(std::chrono::sys_days(
+                             std::chrono::year(2000) / 1 / 2)) +
+                             std::chrono::microseconds(1));
+}
+
+TEST(BinaryDecoders, TestInfiniteTimestampsAndDates) {
+    std::vector<std::byte> buffer;
+    appendBigEndian(buffer, std::numeric_limits<std::int64_t>::max(), 8);
+    EXPECT_EQ(decodeBinary<Timestamp>(buffer).value(), Timestamp::max());
+    buffer.clear();
+    appendBigEndian(buffer, std::numeric_limits<std::int64_t>::min(), 8);
+    EXPECT_EQ(decodeBinary<Timestamp>(buffer).value(), Timestamp::min());
+    buffer.clear();
+    appendBigEndian(buffer, std::numeric_limits<std::int64_t>::max() - 1, 8);
+    EXPECT_EQ(decodeBinary<Timestamp>(buffer).value(), Timestamp::max());
+    buffer.clear();
+    appendBigEndian(buffer, 0, 8);
+    const auto &postgresEpoch = std::chrono::year(2000) / 1 / 1;
+    EXPECT_EQ(decodeBinary<Timestamp>(buffer).value(),
+              Timestamp(std::chrono::sys_days(postgresEpoch)));
+
+    buffer.clear();
+    appendBigEndian(buffer, std::numeric_limits<std::int32_t>::max(), 4);
+    EXPECT_EQ(decodeBinary<Date>(buffer).value(), Date::max());
+    buffer.clear();
+    appendBigEndian(
+        buffer,
+        static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::min()),
+        4);
+    EXPECT_EQ(decodeBinary<Date>(buffer).value(), Date::min());
+}
+
+TEST(BinaryDecoders, TestNumeric) {
+    const auto &buffer = buildNumeric(1, 0x4000, 3, { 1, 2345, 6780 });
+    const auto &numeric = decodeBinary<Numeric>(buffer);
+    ASSERT_TRUE(numeric.has_value()) << numeric.error().message();
+    EXPECT_EQ(numeric.value().toString(), "-12345.678");
+    EXPECT_DOUBLE_EQ(numeric.value().toDouble(), -12345.678);
+
+    const auto &smallBuffer = buildNumeric(-1, 0, 2, { 500 });
+    EXPECT_EQ(decodeBinary<Numeric>(smallBuffer).value().toString(), "0.05");
+    const auto &nanBuffer = buildNumeric(0, 0xC000, 0, {});
+    EXPECT_TRUE(decodeBinary<Numeric>(nanBuffer).value().isNaN());
+}
+
+TEST(BinaryDecoders, TestArray) {
+    std::vector<std::byte> buffer;
+    appendBigEndian(buffer, 1, 4);
+    appendBigEndian(buffer, 1, 4);
+    appendBigEndian(buffer, 23, 4);
+    appendBigEndian(buffer, 3, 4);
+    appendBigEndian(buffer, 1, 4);
+    appendBigEndian(buffer, 4, 4);
+    appendBigEndian(buffer, 7, 4);
+    appendBigEndian(buffer, 0xFFFFFFFF, 4);
+    appendBigEndian(buffer, 4, 4);
+    appendBigEndian(buffer, 9, 4);
+
+    const auto &decoded = decodeBinary(1007, buffer);
+    ASSERT_TRUE(decoded.has_value()) << decoded.error().message();
+    const auto &array = std::get<ArrayView>(decoded.value());
+    EXPECT_EQ(array.elementOid, 23);
+    EXPECT_EQ(array.size(), 3);
+    EXPECT_EQ(array.lowerBound(0), 1);
+    std::vector<std::optional<std::int32_t>> values;
+    for (const auto &element : array) {
+        if (!element.has_value()) {
+            values.push_back(std::nullopt);
+            continue;
+        };
+        values.push_back(decodeBinary<std::int32_t>(element.value()).value());
+    };
+    EXPECT_EQ(values, (std::vector<std::optional<std::int32_t>>{
+                          7, std::nullopt, 9 }));
+
+    buffer.pop_back();
+    EXPECT_FALSE(decodeBinary(1007, buffer).has_value());
+}
@@ -0,0 +1,116 @@
+#include "../pgoutput/columnar.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(ColumnarAccumulator, TestBuildsColumnBuffers) {
+    const std::vector<events::CachedRelationColumn> columns = {
+        { .flags = 1, .name = "id", .oid = 23, .typeModifier = -1 },
+        { .flags = 0, .name = "active", .oid = 16, .typeModifier = -1 },
+        { .flags = 0, .name = "name", .oid = 25, .typeModifier = -1 },
+    };
+    const events::RelationSchema schema = { .oid = 16384,
+                                            .relationNamespace = "public",
+                                            .name = "users",
+                                            .replicaIdentity = 'd',
+                                            .columns = columns };
+    ColumnarAccumulator accumulator(schema, BinaryValue::OFF, 4);
+
+    const auto &buildRow = [](std::string_view id, std::string_view active,
+                              std::string_view name) {
+        std::vector<char> buffer = { 'I' };
+        appendInt32(buffer, 16384);
+        buffer.push_back('N');
+        appendInt16(buffer, 3);
+        appendTextColumn(buffer, id);
+        appendTextColumn(buffer, active);
+        appendTextColumn(buffer, name);
+        return buffer;
+    };
+    auto first = buildInsert(16384);
+    auto second = buildRow("7", "t", "x");
+    auto invalid = buildRow("seven", "f", "y");
+    for (auto *buffer : { &first, &second, &invalid }) {
+        const auto &event = BorrowedTextContext::parseEvent(*buffer);
+        ASSERT_TRUE(event.has_value()) << event.error().message();
+        const auto &result = accumulator.append(
+            std::get<BorrowedTextContext::events::Insert>(event.value()));
+        EXPECT_EQ(result.has_value(), buffer != &invalid);
+    };
+
+    ASSERT_EQ(accumulator.size(), 2);
+    EXPECT_EQ(accumulator.operations()[1], RowOperation::INSERT);
+    const auto &buffers = accumulator.columnBuffers();
+    ASSERT_EQ(buffers.size(), 3);
+    EXPECT_EQ(buffers[0].layout, ColumnLayout::INT32);
+    EXPECT_EQ(buffers[0].valuesAs<std::int32_t>().size(), 2);
+    EXPECT_EQ(buffers[0].valuesAs<std::int32_t>()[0], 42);
+    EXPECT_EQ(buffers[0].valuesAs<std::int32_t>()[1], 7);
+    EXPECT_EQ(buffers[1].nullCount, 1);
+    EXPECT_FALSE(buffers[1].isValid(0));
+    EXPECT_TRUE(buffers[1].isValid(1));
+    EXPECT_EQ(buffers[1].values[0], std::byte{ 0b10 });
+    EXPECT_EQ(buffers[2].offsets().size(), 3);
+    EXPECT_EQ(buffers[2].offsets()[2], 6);
+    EXPECT_EQ(std::string_view(
+                  reinterpret_cast<const char *>(buffers[2].data.data()),
+                  buffers[2].data.size()),
+              "hellox");
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffers[0].values.data()) % 64,
+              0);
+
+    accumulator.clear();
+    EXPECT_EQ(accumulator.size(), 0);
+    EXPECT_EQ(accumulator.columnBuffers()[2].offsets().size(), 1);
+}
+
+TEST(ColumnarAccumulator, TestClampsInfiniteDatesAndRejectsKeylessDelete) {
+    const std::vector<events::CachedRelationColumn> columns = {
+        { .flags = 1, .name = "day", .oid = 1082, .typeModifier = -1 },
+    };
+    const events::RelationSchema schema = { .oid = 16384,
+                                            .relationNamespace = "public",
+                                            .name = "days",
+                                            .replicaIdentity = 'd',
+                                            .columns = columns };
+    ColumnarAccumulator accumulator(schema, BinaryValue::OFF, 4);
+    for (const auto &day : { "infinity", "-infinity", "1970-01-02" }) {
+        std::vector<char> buffer = { 'I' };
+        appendInt32(buffer, 16384);
+        buffer.push_back('N');
+        appendInt16(buffer, 1);
+        appendTextColumn(buffer, day);
+        const auto &event = BorrowedTextContext::parseEvent(buffer);
+        ASSERT_TRUE(event.has_value()) << event.error().message();
+        ASSERT_TRUE(accumulator
+                        .append(std::get<BorrowedTextContext::events::Insert>(
+                            event.value()))
+                        .has_value());
+    };
+    const auto &days = accumulator.columnBuffers()[0].valuesAs<std::int32_t>();
+    ASSERT_EQ(days.size(), 3);
+    EXPECT_EQ(days[0], std::numeric_limits<std::int32_t>::max());
+    EXPECT_EQ(days[1], std::numeric_limits<std::int32_t>::min());
+    EXPECT_EQ(days[2], 1);
+
+    const auto &keyless = accumulator.append(
+        BorrowedTextContext::events::Delete{ .oid = 16384 });
+    ASSERT_FALSE(keyless.has_value());
+    EXPECT_EQ(keyless.error().code, ParseErrorCode::MISSING_OLD_TUPLE);
+    EXPECT_EQ(accumulator.size(), 3);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../pgoutput/pgoutput.hpp"
+
+// Text-mode sessions shared by the pgoutput tests, one per option the tests
+// exercise on top of the defaults.
+namespace PGREPLICATION_NAMESPACE::tests {
+using TextContext = pgoutput::SessionContext<
+    pgoutput::BinaryValue::OFF,
+    pgoutput::MessagesValue::OFF,
+    pgoutput::StreamingValue::OFF,
+    pgoutput::TwoPhaseValue::OFF,
+    pgoutput::OriginValue::NONE>;
+using BorrowedTextContext = pgoutput::SessionContext<
+    pgoutput::BinaryValue::OFF,
+    pgoutput::MessagesValue::OFF,
+    pgoutput::StreamingValue::OFF,
+    pgoutput::TwoPhaseValue::OFF,
+    pgoutput::OriginValue::NONE,
+    pgoutput::TupleStorageValue::BORROWED>;
+using StreamingTextContext = pgoutput::SessionContext<
+    pgoutput::BinaryValue::OFF,
+    pgoutput::MessagesValue::OFF,
+    pgoutput::StreamingValue::PARALLEL,
+    pgoutput::TwoPhaseValue::OFF,
+    pgoutput::OriginValue::NONE>;
+using LazyTextContext = pgoutput::SessionContext<
+    pgoutput::BinaryValue::OFF,
+    pgoutput::MessagesValue::OFF,
+    pgoutput::StreamingValue::OFF,
+    pgoutput::TwoPhaseValue::OFF,
+    pgoutput::OriginValue::NONE,
+    pgoutput::TupleStorageValue::LAZY>;
+using PackedTextContext = pgoutput::SessionContext<
+    pgoutput::BinaryValue::OFF,
+    pgoutput::MessagesValue::OFF,
+    pgoutput::StreamingValue::OFF,
+    pgoutput::TwoPhaseValue::OFF,
+    pgoutput::OriginValue::NONE,
+    pgoutput::TupleStorageValue::PACKED>;
+using ArenaTextContext = pgoutput::SessionContext<
+    pgoutput::BinaryValue::OFF,
+    pgoutput::MessagesValue::OFF,
+    pgoutput::StreamingValue::OFF,
+    pgoutput::TwoPhaseValue::OFF,
+    pgoutput::OriginValue::NONE,
+    pgoutput::TupleStorageValue::ARENA>;
+using StreamingArenaTextContext = pgoutput::SessionContext<
+    pgoutput::BinaryValue::OFF,
+    pgoutput::MessagesValue::OFF,
+    pgoutput::StreamingValue::PARALLEL,
+    pgoutput::TwoPhaseValue::OFF,
+    pgoutput::OriginValue::NONE,
+    pgoutput::TupleStorageValue::ARENA>;
+using TrustedTextContext = pgoutput::SessionContext<
+    pgoutput::BinaryValue::OFF,
+    pgoutput::MessagesValue::OFF,
+    pgoutput::StreamingValue::OFF,
+    pgoutput::TwoPhaseValue::OFF,
+    pgoutput::OriginValue::NONE,
+    pgoutput::TupleStorageValue::OWNED,
+    pgoutput::ValidationValue::TRUSTED>;
+};  // namespace PGREPLICATION_NAMESPACE::tests
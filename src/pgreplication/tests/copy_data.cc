@@ -0,0 +1,92 @@
+#include "../copy_data.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "../events.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+
+TEST(CopyDataFramer, TestFramesAcrossChunkBoundaries) {
+    char walData[] = "hello!";
+    const auto &xLogData =
+        XLogData{ .messageWalStart = 1,
+                  .serverWalEnd = 2,
+                  .sentAtUnixTimestamp = 3,
+                  .walData = std::span<char>(walData, sizeof(walData) - 1) };
+    const auto &keepalive = PrimaryKeepaliveMessage{
+        .serverWalEnd = 4, .sentAtUnixTimestamp = 5, .replyRequested = true
+    };
+    std::vector<char> stream(primaryEventNetworkSize(xLogData) +
+                             primaryEventNetworkSize(keepalive) +
+                             2 * CopyDataFramer::headerSize);
+    const auto &xLogDataSize = primaryEventToCopyData(xLogData, stream);
+    ASSERT_TRUE(xLogDataSize.has_value()) << xLogDataSize.error().message();
+    const auto &keepaliveSize = primaryEventToCopyData(
+        keepalive, std::span(stream).subspan(xLogDataSize.value()));
+    ASSERT_TRUE(keepaliveSize.has_value()) << keepaliveSize.error().message();
+    EXPECT_EQ(xLogDataSize.value() + keepaliveSize.value(), stream.size());
+
+    CopyDataFramer framer(64);
+    std::vector<PrimaryEvent> events;
+    std::vector<char> receivedWalData;
+    for (std::size_t position = 0; position < stream.size(); position += 3) {
+        const auto &chunk = std::span(stream).subspan(
+            position, std::min<std::size_t>(3, stream.size() - position));
+        EXPECT_EQ(framer.feed(chunk), chunk.size());
+        while (true) {
+            auto result = framer.next();
+            ASSERT_TRUE(result.has_value()) << result.error().message();
+            if (!result.value().has_value()) break;
+            if (std::holds_alternative<XLogData>(result.value().value())) {
+                const auto &data = std::get<XLogData>(result.value().value());
+                receivedWalData.assign(data.walData.begin(),
+                                       data.walData.end());
+            };
+            events.push_back(result.value().value());
+        };
+    };
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(std::get<XLogData>(events[0]).serverWalEnd, 2);
+    EXPECT_EQ(std::string_view(receivedWalData.data(), receivedWalData.size()),
+              "hello!");
+    EXPECT_EQ(std::get<PrimaryKeepaliveMessage>(events[1]).serverWalEnd, 4);
+    EXPECT_TRUE(std::get<PrimaryKeepaliveMessage>(events[1]).replyRequested);
+    EXPECT_EQ(framer.buffered(), 0);
+}
+
+TEST(CopyDataFramer, TestRejectsOversizedMessage) {
+    char stream[] = { 'd', 0, 0, 1, 0 };
+    CopyDataFramer framer(64);
+    framer.feed(stream);
+    const auto &result = framer.next();
+    EXPECT_FALSE(result.has_value());
+}
+
+TEST(CopyDataFramer, TestEncoderRejectsShortBuffer) {
+    const auto &update = StandbyStatusUpdate{ .writtenWalPosition = 1,
+                                              .flushedWalPosition = 2,
+                                              .appliedWalPosition = 3,
+                                              .sentAtUnixTimestamp = 4,
+                                              .replyRequested = false };
+    char buffer[CopyDataFramer::headerSize + 1 + StandbyStatusUpdate::size];
+    EXPECT_FALSE(
+        standbyEventToCopyData(update, std::span(buffer).first(10))
+            .has_value());
+    const auto &size = standbyEventToCopyData(update, buffer);
+    ASSERT_TRUE(size.has_value()) << size.error().message();
+    EXPECT_EQ(size.value(), sizeof(buffer));
+    const auto &decoded = standbyEventFromNetworkBuffer(
+        std::span(buffer).subspan(CopyDataFramer::headerSize));
+    ASSERT_TRUE(decoded.has_value()) << decoded.error().message();
+    EXPECT_EQ(std::get<StandbyStatusUpdate>(decoded.value()).appliedWalPosition,
+              3);
+}
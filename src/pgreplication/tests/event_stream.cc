@@ -0,0 +1,134 @@
+#include "../pgoutput/event_stream.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "../local_wal_sender.hpp"
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(AsyncEventStream, TestSuspendsOnlyForMoreBytes) {
+    using events = BorrowedTextContext::events;
+    // Read awaitable completed by hand, standing in for an event loop.
+    struct ManualSource {
+        std::coroutine_handle<> waiting;
+        std::span<char> target;
+        std::size_t received = 0;
+        int reads = 0;
+
+        auto operator()(std::span<char> buffer) {
+            struct Awaiter {
+                ManualSource &source;
+                std::span<char> buffer;
+
+                bool await_ready() const { return false; };
+                void await_suspend(std::coroutine_handle<> handle) {
+                    source.waiting = handle;
+                    source.target = buffer;
+                    source.reads++;
+                };
+                std::size_t await_resume() const { return source.received; };
+            };
+            return Awaiter{ *this, buffer };
+        };
+
+        void deliver(std::span<const char> bytes) {
+            received = std::min(bytes.size(), target.size());
+            std::copy_n(bytes.begin(), received, target.begin());
+            std::exchange(waiting, {}).resume();
+        };
+    };
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() { return {}; };
+            std::suspend_never initial_suspend() { return {}; };
+            std::suspend_never final_suspend() noexcept { return {}; };
+            void return_void() {};
+            void unhandled_exception() { std::terminate(); };
+        };
+    };
+
+    LocalWalSender sender;
+    for (std::int64_t lsn = 0; lsn < 3; lsn++) {
+        auto insert = buildInsert(16384);
+        sender.send(insert, lsn);
+    };
+    sender.sendKeepalive(500, true);
+    auto commit = buildCommit(100);
+    sender.send(commit, 3);
+    sender.finish();
+    std::vector<char> bytes(4096);
+    bytes.resize(sender.read(bytes));
+
+    ManualSource source;
+    int keepalives = 0;
+    auto stream = streamEvents<BorrowedTextContext>(
+        std::ref(source),
+        [&keepalives](const PrimaryKeepaliveMessage &keepalive) {
+            EXPECT_TRUE(keepalive.replyRequested);
+            keepalives++;
+        },
+        1024);
+    std::string received;
+    bool finished = false;
+    const auto &consume = [&]() -> Detached {
+        while (auto *result = co_await stream.next()) {
+            EXPECT_TRUE(result->has_value()) << result->error().message();
+            if (!result->has_value()) break;
+            if (const auto *insert =
+                    std::get_if<events::Insert>(&result->value())) {
+                received += std::get<std::string_view>(insert->data[2]);
+            } else if (std::holds_alternative<events::Commit>(
+                           result->value())) {
+                received += ';';
+            };
+        };
+        finished = true;
+    };
+    consume();
+
+    // The first chunk ends in the middle of the second message.
+    const auto split = bytes.size() / 4;
+    EXPECT_EQ(source.reads, 1);
+    source.deliver(std::span(bytes).first(split));
+    EXPECT_EQ(received, "hello");
+    EXPECT_EQ(source.reads, 2);
+    source.deliver(std::span(bytes).subspan(split));
+    EXPECT_EQ(received, "hellohellohello;");
+    EXPECT_EQ(keepalives, 1);
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(source.reads, 2);
+
+    // A connection cut inside a message is not a clean end.
+    ManualSource cut;
+    auto truncated = streamEvents<BorrowedTextContext>(std::ref(cut));
+    std::optional<ParseError> error;
+    const auto &consumeTruncated = [&]() -> Detached {
+        while (auto *result = co_await truncated.next()) {
+            if (!result->has_value()) error = result->error();
+        };
+    };
+    consumeTruncated();
+    cut.deliver(std::span(bytes).first(split));
+    cut.deliver({});
+    ASSERT_TRUE(error.has_value());
+    EXPECT_EQ(error->code, ParseErrorCode::TRUNCATED_STREAM);
+}
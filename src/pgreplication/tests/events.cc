@@ -66,7 +66,7 @@ TEST(XLogData, TestFromNetworkBufferConstructor) {
     std::memcpy(bufferSpan.subspan(24, sizeof(walData)).data(), walData,
                 sizeof(walData));
     const auto &result = pgreplication::XLogData::fromNetworkBuffer(bufferSpan);
-    ASSERT_TRUE(result.has_value()) << result.error();
+    ASSERT_TRUE(result.has_value()) << result.error().message();
     const auto &data = result.value();
     EXPECT_EQ(data.messageWalStart, 1);
     EXPECT_EQ(data.serverWalEnd, 2);
@@ -0,0 +1,73 @@
+#include "../feedback.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../events.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace std::chrono_literals;
+
+namespace {
+StandbyStatusUpdate decode(FeedbackController::frame &frame) {
+    EXPECT_EQ(frame[0],
+              static_cast<char>(StandbyEventType::StandbyStatusUpdate));
+    return StandbyStatusUpdate::fromNetworkBuffer(
+        std::span(frame).subspan<1, StandbyStatusUpdate::size>());
+};
+};  // namespace
+
+TEST(FeedbackController, TestCoalescesAdvances) {
+    FeedbackController controller(10s, 100ms, false);
+    const auto &start = FeedbackController::clock::now();
+    EXPECT_FALSE(controller.poll(start).has_value());
+
+    std::vector<std::jthread> threads;
+    for (int thread = 0; thread < 4; thread++) {
+        threads.emplace_back([&controller, thread] {
+            for (std::int64_t lsn = 1; lsn <= 1000; lsn++) {
+                controller.advanceFlushed(lsn * 4 + thread);
+            };
+        });
+    };
+    threads.clear();
+    controller.advanceApplied(100);
+    EXPECT_EQ(controller.flushed(), 4003);
+    EXPECT_EQ(controller.written(), 4003);
+
+    EXPECT_FALSE(controller.poll(start + 50ms).has_value());
+    auto frame = controller.poll(start + 150ms);
+    ASSERT_TRUE(frame.has_value());
+    const auto &status = decode(frame.value());
+    EXPECT_EQ(status.writtenWalPosition, 4003);
+    EXPECT_EQ(status.flushedWalPosition, 4003);
+    EXPECT_EQ(status.appliedWalPosition, 100);
+    EXPECT_FALSE(status.replyRequested);
+
+    EXPECT_FALSE(controller.poll(start + 300ms).has_value());
+    EXPECT_TRUE(controller.poll(start + 150ms + 10s).has_value());
+}
+
+TEST(FeedbackController, TestKeepaliveReplyAndIdleAdvance) {
+    FeedbackController controller;
+    const auto &start = FeedbackController::clock::now();
+    controller.observe(XLogData{ .messageWalStart = 50 });
+    controller.observe(PrimaryKeepaliveMessage{ .serverWalEnd = 80,
+                                                .replyRequested = true });
+    EXPECT_EQ(controller.applied(), 0);
+
+    auto frame = controller.poll(start);
+    ASSERT_TRUE(frame.has_value());
+    EXPECT_EQ(decode(frame.value()).writtenWalPosition, 50);
+    EXPECT_FALSE(controller.poll(start).has_value());
+
+    controller.advanceApplied(60);
+    controller.observe(PrimaryKeepaliveMessage{ .serverWalEnd = 90 });
+    EXPECT_EQ(controller.applied(), 90);
+    EXPECT_EQ(controller.flushed(), 90);
+}
@@ -0,0 +1,76 @@
+#include "../pgoutput/filter.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <span>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "../pgoutput/origin_filter.hpp"
+#include "../pgoutput/pgoutput.hpp"
+#include "../pgoutput/relation_filter.hpp"
+#include "../utils.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(FilteredSession, TestStacksOriginAndRelationFilters) {
+    using OriginContext =
+        SessionContext<BinaryValue::OFF, MessagesValue::OFF,
+                       StreamingValue::OFF, TwoPhaseValue::OFF,
+                       OriginValue::ANY>;
+    RelationFilter<OriginContext> relationFilter;
+    relationFilter.allow("public", "users", { "name" });
+    FilteredSession<OriginContext, OriginFilter<OriginContext>,
+                    RelationFilter<OriginContext>>
+        session(OriginFilter<OriginContext>({ "local" }),
+                std::move(relationFilter));
+
+    std::vector<std::vector<char>> messages = {
+        buildBegin(100, 1),
+        buildOrigin(90, "local"),
+        buildRelation(16384, "users",
+                      { { "id", true }, { "age", false }, { "name", false } }),
+        buildInsert(16384),
+        buildCommit(100),
+        buildBegin(200, 2),
+        buildOrigin(90, "remote"),
+        buildRelation(16385, "orders", { { "id", true } }),
+        buildInsert(16385),
+        buildInsert(16384),
+        buildCommit(200),
+    };
+    std::vector<std::span<char>> spans(messages.begin(), messages.end());
+    OriginContext::EventBatch batch;
+    EXPECT_EQ(session.parseEvents(spans, batch), 7);
+    ASSERT_TRUE(batch.ok()) << batch.error->error.message();
+
+    std::string types;
+    for (const auto &event : batch.events) {
+        std::visit(
+            utils::overloaded{
+                [&types](const events::Begin &) { types += 'B'; },
+                [&types](const OriginContext::events::Relation &) {
+                    types += 'R';
+                },
+                [&types](const events::Commit &) { types += 'C'; },
+                [&types](const events::Origin &) { types += 'O'; },
+                [&types](const OriginContext::events::Insert &) {
+                    types += 'I';
+                },
+                [&types](const auto &) { types += '?'; } },
+            event);
+    };
+    EXPECT_EQ(types, "BRCBOIC");
+    const auto &insert =
+        std::get<OriginContext::events::Insert>(batch.events[5]);
+    ASSERT_EQ(insert.data.size(), 1);
+    EXPECT_EQ(std::get<std::string>(insert.data[0]), "hello");
+    EXPECT_EQ(session.filter<OriginFilter<OriginContext>>().skipped(), 2);
+    EXPECT_EQ(session.filter<RelationFilter<OriginContext>>().skipped(), 2);
+}
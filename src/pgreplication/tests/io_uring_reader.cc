@@ -0,0 +1,152 @@
+#include "../io_uring_reader.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#ifdef PGREPLICATION_IO_URING
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "../error.hpp"
+#include "../events.hpp"
+#include "../local_wal_sender.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+
+namespace {
+std::vector<std::string> recordedMessages() {
+    std::vector<std::string> messages;
+    for (std::size_t size : { 10, 59, 60, 200, 700, 3, 64, 1 }) {
+        std::string message(size, '\0');
+        for (std::size_t index = 0; index < size; index++) {
+            message[index] =
+                static_cast<char>('a' + (messages.size() + index) % 26);
+        };
+        messages.push_back(std::move(message));
+    };
+    return messages;
+};
+
+std::vector<char> recordStream(const std::vector<std::string> &messages) {
+    LocalWalSender sender;
+    for (std::size_t index = 0; index < messages.size(); index++) {
+        auto message = messages[index];
+        sender.send(message, static_cast<std::int64_t>(index));
+        if (index == 2) sender.sendKeepalive(100, false);
+    };
+    sender.finish();
+    std::vector<char> stream;
+    char buffer[256];
+    while (const auto size = sender.read(buffer)) {
+        stream.insert(stream.end(), buffer, buffer + size);
+    };
+    return stream;
+};
+
+void expectReplayed(IoUringReader &reader,
+                    const std::vector<std::string> &messages) {
+    std::vector<std::string> received;
+    std::size_t keepalives = 0;
+    while (true) {
+        const auto &event = reader.next();
+        ASSERT_TRUE(event.has_value()) << event.error().message();
+        if (!event.value().has_value()) break;
+        if (const auto *data = std::get_if<XLogData>(&event.value().value())) {
+            EXPECT_EQ(data->messageWalStart,
+                      static_cast<std::int64_t>(received.size()));
+            received.emplace_back(data->walData.begin(), data->walData.end());
+        } else {
+            keepalives++;
+        };
+    };
+    EXPECT_FALSE(reader.error());
+    EXPECT_EQ(keepalives, 1);
+    EXPECT_EQ(received, messages);
+};
+};  // namespace
+
+TEST(IoUringReader, TestReassemblesMessagesAcrossBlocks) {
+    const auto &messages = recordedMessages();
+    const auto &stream = recordStream(messages);
+
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    // Blocks smaller than most messages, and fewer than the largest one
+    // needs, so the spill path and a receive running out of blocks are hit.
+    auto reader = IoUringReader::create(sockets[0], 64, 4);
+    if (!reader.has_value()) {
+        close(sockets[0]);
+        close(sockets[1]);
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reader.error().message();
+    };
+    std::jthread writer([&stream, socket = sockets[1]] {
+        for (std::size_t offset = 0; offset < stream.size(); offset += 37) {
+            const auto size =
+                std::min<std::size_t>(37, stream.size() - offset);
+            ASSERT_EQ(write(socket, stream.data() + offset, size),
+                      static_cast<ssize_t>(size));
+        };
+        close(socket);
+    });
+    expectReplayed(*reader.value(), messages);
+    writer.join();
+    close(sockets[0]);
+}
+
+TEST(IoUringReader, TestReadsRecordedFile) {
+    const auto &messages = recordedMessages();
+    const auto &stream = recordStream(messages);
+
+    auto *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(std::fwrite(stream.data(), 1, stream.size(), file),
+              stream.size());
+    std::fflush(file);
+    std::rewind(file);
+    auto reader = IoUringReader::create(fileno(file), 128, 2);
+    if (!reader.has_value()) {
+        std::fclose(file);
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reader.error().message();
+    };
+    expectReplayed(*reader.value(), messages);
+    std::fclose(file);
+}
+
+TEST(IoUringReader, TestReportsTruncatedInput) {
+    const auto &stream = recordStream(recordedMessages());
+    auto *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    // Ends inside the 700 byte message.
+    const auto size = stream.size() / 2;
+    ASSERT_EQ(std::fwrite(stream.data(), 1, size, file), size);
+    std::fflush(file);
+    std::rewind(file);
+    auto reader = IoUringReader::create(fileno(file), 128, 2);
+    if (!reader.has_value()) {
+        std::fclose(file);
+        GTEST_SKIP() << "io_uring unavailable: "
+                     << reader.error().message();
+    };
+    while (true) {
+        const auto &event = reader.value()->next();
+        if (!event.has_value()) {
+            EXPECT_EQ(event.error().code, ParseErrorCode::TRUNCATED_STREAM);
+            break;
+        };
+        ASSERT_TRUE(event.value().has_value()) << "ended without an error";
+    };
+    EXPECT_FALSE(reader.value()->error());
+    std::fclose(file);
+}
+#endif
@@ -0,0 +1,105 @@
+#include "../pgoutput/origin_filter.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "../pgoutput/events/base/relation_cache.hpp"
+#include "../pgoutput/pgoutput.hpp"
+#include "../utils.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(OriginFilter, TestSkipsTransactionsFromFilteredOrigins) {
+    using OriginContext =
+        SessionContext<BinaryValue::OFF, MessagesValue::OFF,
+                       StreamingValue::ON, TwoPhaseValue::OFF,
+                       OriginValue::ANY>;
+    OriginFilter<OriginContext> filter({ "local" });
+
+    const auto &buildStreamStart = [](std::int32_t xid, bool first) {
+        std::vector<char> buffer = { 'S' };
+        appendInt32(buffer, xid);
+        buffer.push_back(first ? 1 : 0);
+        return buffer;
+    };
+    std::vector<char> streamedInsert = { 'I' };
+    appendInt32(streamedInsert, 7);
+    appendInt32(streamedInsert, 16384);
+    streamedInsert.push_back('N');
+    appendInt16(streamedInsert, 1);
+    appendTextColumn(streamedInsert, "1");
+    // The first Relation for the oid arrives inside a filtered transaction.
+    auto relation = buildRelation(16384, "users", { { "id", true } });
+    const std::vector<char> relationXid = { 0, 0, 0, 1 };
+    relation.insert(relation.begin() + 1, relationXid.begin(),
+                    relationXid.end());
+    std::vector<char> streamStop = { 'E' };
+    std::vector<char> streamCommit = { 'c' };
+    appendInt32(streamCommit, 7);
+    streamCommit.push_back(0);
+    appendInt64(streamCommit, 100);
+    appendInt64(streamCommit, 101);
+    appendInt64(streamCommit, 0);
+
+    // Insert messages of a streaming session always carry a transaction id.
+    std::vector<std::vector<char>> messages = {
+        buildBegin(100, 1),
+        buildOrigin(90, "local"),
+        relation,
+        streamedInsert,
+        streamedInsert,
+        buildCommit(100),
+        buildBegin(200, 2),
+        buildOrigin(90, "remote"),
+        streamedInsert,
+        buildCommit(200),
+        buildStreamStart(7, true),
+        buildOrigin(90, "local"),
+        streamedInsert,
+        streamStop,
+        buildStreamStart(7, false),
+        streamedInsert,
+        streamStop,
+        streamCommit,
+    };
+    std::vector<std::span<char>> spans(messages.begin(), messages.end());
+    OriginContext::EventBatch batch;
+    filter.parseEvents(spans, batch);
+    ASSERT_TRUE(batch.ok()) << batch.error->error.message();
+
+    std::string types;
+    events::RelationCache relations;
+    for (const auto &event : batch.events) {
+        std::visit(
+            utils::overloaded{
+                [&types](const events::Begin &) { types += 'B'; },
+                [&types, &relations](
+                    const OriginContext::events::Relation &relation) {
+                    relations.apply(relation);
+                    types += 'R';
+                },
+                [&types](const events::Commit &) { types += 'C'; },
+                [&types](const events::Origin &) { types += 'O'; },
+                [&types](const OriginContext::events::Insert &) {
+                    types += 'I';
+                },
+                [&types](const events::StreamStart &) { types += 'S'; },
+                [&types](const events::StreamStop &) { types += 'E'; },
+                [&types](const events::StreamCommit &) { types += 'c'; },
+                [&types](const auto &) { types += '?'; } },
+            event);
+    };
+    EXPECT_EQ(types, "BRCBOICSESEc");
+    EXPECT_EQ(filter.skipped(), 6);
+    EXPECT_TRUE(relations.find(16384).has_value());
+    EXPECT_FALSE(filter.inFilteredTransaction());
+}
@@ -0,0 +1,159 @@
+#include "../pgoutput/parallel_apply.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "../utils.hpp"
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(ParallelApplyScheduler, TestCommitsFollowDispatchOrder) {
+    using events = StreamingTextContext::events;
+    std::mutex mutex;
+    std::vector<std::int32_t> commits;
+    std::vector<std::pair<std::int32_t, std::thread::id>> applied;
+    ParallelApplyScheduler<StreamingTextContext> scheduler(
+        2, [&](const StreamingTextContext::Event &event) {
+            if (const auto *insert = std::get_if<events::Insert>(&event)) {
+                if (insert->transactionId == 2) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                };
+                std::lock_guard lock(mutex);
+                applied.emplace_back(insert->transactionId,
+                                     std::this_thread::get_id());
+            } else if (const auto *commit =
+                           std::get_if<events::StreamCommit>(&event)) {
+                std::lock_guard lock(mutex);
+                commits.push_back(commit->transactionId);
+            };
+        });
+
+    const auto &streamInsert = [](std::int32_t xid) {
+        const auto &insert = buildInsert(16384);
+        std::vector<char> buffer = { 'I' };
+        appendInt32(buffer, xid);
+        buffer.insert(buffer.end(), insert.begin() + 1, insert.end());
+        auto event = StreamingTextContext::parseEvent(buffer);
+        EXPECT_TRUE(event.has_value()) << event.error().message();
+        return std::move(event.value());
+    };
+    for (std::int32_t xid = 1; xid <= 2; xid++) {
+        scheduler.dispatch(events::StreamStart{ .transactionId = xid });
+        scheduler.dispatch(streamInsert(xid));
+        scheduler.dispatch(streamInsert(xid));
+        scheduler.dispatch(events::StreamStop{});
+    };
+    EXPECT_EQ(scheduler.inFlight(), 2);
+    scheduler.dispatch(events::StreamCommit{ .transactionId = 2,
+                                             .endLsn = 200 });
+    scheduler.dispatch(events::StreamCommit{ .transactionId = 1,
+                                             .endLsn = 300 });
+    scheduler.drain();
+
+    EXPECT_EQ(scheduler.inFlight(), 0);
+    EXPECT_EQ(scheduler.flushedLsn(), 300);
+    EXPECT_EQ(commits, (std::vector<std::int32_t>{ 2, 1 }));
+    ASSERT_EQ(applied.size(), 4);
+    for (const auto &[xid, thread] : applied) {
+        for (const auto &[otherXid, otherThread] : applied) {
+            if (xid == otherXid) {
+                EXPECT_EQ(thread, otherThread);
+            };
+        };
+    };
+}
+
+TEST(ParallelApplyScheduler, TestOrdersTwoPhaseCommits) {
+    using TwoPhaseContext =
+        SessionContext<BinaryValue::OFF, MessagesValue::OFF,
+                       StreamingValue::ON, TwoPhaseValue::ON,
+                       OriginValue::NONE>;
+    using events = TwoPhaseContext::events;
+    std::mutex mutex;
+    std::vector<std::pair<std::string, std::thread::id>> applied;
+    ParallelApplyScheduler<TwoPhaseContext> scheduler(
+        2, [&](const TwoPhaseContext::Event &event) {
+            const auto &name = std::visit(
+                utils::overloaded{
+                    [](const events::Insert &insert) {
+                        if (insert.transactionId == 1) {
+                            std::this_thread::sleep_for(
+                                std::chrono::milliseconds(20));
+                        };
+                        return "I" + std::to_string(insert.transactionId);
+                    },
+                    [](const events::StreamPrepare &prepare) {
+                        return "SP" + std::to_string(prepare.transactionId);
+                    },
+                    [](const events::Prepare &prepare) {
+                        return "P" + std::to_string(prepare.transactionId);
+                    },
+                    [](const events::CommitPrepared &commit) {
+                        return "CP" + std::to_string(commit.transactionId);
+                    },
+                    [](const auto &) { return std::string(); } },
+                event);
+            if (name.empty()) return;
+            std::lock_guard lock(mutex);
+            applied.emplace_back(name, std::this_thread::get_id());
+        });
+
+    const auto &streamInsert = [](std::int32_t xid) {
+        const auto &insert = buildInsert(16384);
+        std::vector<char> buffer = { 'I' };
+        appendInt32(buffer, xid);
+        buffer.insert(buffer.end(), insert.begin() + 1, insert.end());
+        auto event = TwoPhaseContext::parseEvent(buffer);
+        EXPECT_TRUE(event.has_value()) << event.error().message();
+        return std::move(event.value());
+    };
+    ASSERT_TRUE(
+        scheduler.dispatch(events::StreamStart{ .transactionId = 1 }));
+    ASSERT_TRUE(scheduler.dispatch(streamInsert(1)));
+    ASSERT_TRUE(scheduler.dispatch(events::StreamStop{}));
+    ASSERT_TRUE(scheduler.dispatch(
+        events::StreamPrepare{ .endLsn = 100, .transactionId = 1 }));
+    ASSERT_TRUE(
+        scheduler.dispatch(events::BeginPrepare{ .transactionId = 2 }));
+    ASSERT_TRUE(scheduler.dispatch(streamInsert(2)));
+    ASSERT_TRUE(scheduler.dispatch(
+        events::Prepare{ .endLsn = 200, .transactionId = 2 }));
+    ASSERT_TRUE(scheduler.dispatch(
+        events::CommitPrepared{ .endLsn = 300, .transactionId = 1 }));
+    const auto &unknown = scheduler.dispatch(
+        events::StreamAbort{ .transactionId = 9, .subTransactionId = 10 });
+    ASSERT_FALSE(unknown.has_value());
+    EXPECT_EQ(unknown.error().code, ParseErrorCode::UNEXPECTED_EVENT);
+    scheduler.drain();
+
+    EXPECT_EQ(scheduler.inFlight(), 0);
+    EXPECT_EQ(scheduler.flushedLsn(), 300);
+    std::vector<std::string> names;
+    for (const auto &[name, thread] : applied) names.push_back(name);
+    EXPECT_EQ(names.back(), "CP1");
+    const auto &position = [&names](std::string_view name) {
+        return std::ranges::find(names, name) - names.begin();
+    };
+    EXPECT_LT(position("I1"), position("SP1"));
+    EXPECT_LT(position("SP1"), position("P2"));
+    EXPECT_LT(position("I2"), position("P2"));
+    EXPECT_EQ(applied[position("I1")].second,
+              applied[position("SP1")].second);
+    EXPECT_EQ(applied[position("I2")].second,
+              applied[position("P2")].second);
+}
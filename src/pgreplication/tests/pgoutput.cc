@@ -0,0 +1,283 @@
+#include "../pgoutput/pgoutput.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "../pgoutput/events/base/relation_cache.hpp"
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(Insert, TestOwnedParse) {
+    auto buffer = buildInsert(16384);
+    const auto &result = TextContext::parseEvent(buffer);
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+    const auto &insert =
+        std::get<TextContext::events::Insert>(result.value());
+    EXPECT_EQ(insert.oid, 16384);
+    ASSERT_EQ(insert.data.size(), 3);
+    EXPECT_EQ(std::get<std::string>(insert.data[0]), "42");
+    EXPECT_TRUE(std::holds_alternative<events::PGNull>(insert.data[1]));
+    EXPECT_EQ(std::get<std::string>(insert.data[2]), "hello");
+}
+
+TEST(Insert, TestBorrowedParsePointsIntoBuffer) {
+    auto buffer = buildInsert(16384);
+    const auto &result = BorrowedTextContext::parseEvent(buffer);
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+    const auto &insert =
+        std::get<BorrowedTextContext::events::Insert>(result.value());
+    ASSERT_EQ(insert.data.size(), 3);
+    const auto &value = std::get<std::string_view>(insert.data[2]);
+    EXPECT_EQ(value, "hello");
+    EXPECT_GE(value.data(), buffer.data());
+    EXPECT_LE(value.data() + value.size(), buffer.data() + buffer.size());
+
+    const auto &owned = insert.materialize();
+    buffer.assign(buffer.size(), 0);
+    EXPECT_EQ(owned.oid, 16384);
+    EXPECT_EQ(std::get<std::string>(owned.data[0]), "42");
+    EXPECT_TRUE(std::holds_alternative<events::PGNull>(owned.data[1]));
+    EXPECT_EQ(std::get<std::string>(owned.data[2]), "hello");
+}
+
+TEST(Insert, TestLazyParseDecodesOnAccess) {
+    auto buffer = buildInsert(16384);
+    const auto &result = LazyTextContext::parseEvent(buffer);
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+    const auto &insert =
+        std::get<LazyTextContext::events::Insert>(result.value());
+    EXPECT_EQ(insert.oid, 16384);
+    ASSERT_EQ(insert.data.size(), 3);
+    EXPECT_EQ(std::get<std::string_view>(insert.data[2]), "hello");
+    EXPECT_TRUE(std::holds_alternative<events::PGNull>(insert.data[1]));
+    EXPECT_EQ(std::get<std::string_view>(insert.data.at(0)), "42");
+    EXPECT_THROW(insert.data.at(3), std::out_of_range);
+
+    const auto &owned = insert.materialize();
+    buffer.assign(buffer.size(), 0);
+    ASSERT_EQ(owned.data.size(), 3);
+    EXPECT_EQ(std::get<std::string>(owned.data[0]), "42");
+    EXPECT_EQ(std::get<std::string>(owned.data[2]), "hello");
+}
+
+TEST(Insert, TestPackedParseOwnsOneBuffer) {
+    auto buffer = buildInsert(16384);
+    const auto &result = PackedTextContext::parseEvent(buffer);
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+    const auto insert =
+        std::get<PackedTextContext::events::Insert>(result.value());
+    buffer.assign(buffer.size(), 0);
+    EXPECT_EQ(insert.oid, 16384);
+    ASSERT_EQ(insert.data.size(), 3);
+    EXPECT_EQ(insert.data.storage.size(),
+              3 * sizeof(events::PackedColumnHeader));
+    EXPECT_EQ(std::get<std::string_view>(insert.data[0]), "42");
+    EXPECT_TRUE(std::holds_alternative<events::PGNull>(insert.data[1]));
+    EXPECT_EQ(std::get<std::string_view>(insert.data.at(2)), "hello");
+    EXPECT_THROW(insert.data.at(3), std::out_of_range);
+
+    std::vector<char> wide = { 'I' };
+    appendInt32(wide, 16384);
+    wide.push_back('N');
+    appendInt16(wide, 2);
+    appendTextColumn(wide, "a value longer than the header");
+    wide.push_back('u');
+    const auto &wideResult = PackedTextContext::parseEvent(wide);
+    ASSERT_TRUE(wideResult.has_value()) << wideResult.error().message();
+    const auto &wideInsert =
+        std::get<PackedTextContext::events::Insert>(wideResult.value());
+    EXPECT_EQ(wideInsert.data.storage.size(),
+              2 * sizeof(events::PackedColumnHeader) + 30);
+    EXPECT_EQ(std::get<std::string_view>(wideInsert.data[0]),
+              "a value longer than the header");
+    EXPECT_TRUE(std::holds_alternative<events::PGUnchangedToastedValue>(
+        wideInsert.data[1]));
+
+    const auto &owned = insert.materialize();
+    ASSERT_EQ(owned.data.size(), 3);
+    EXPECT_EQ(std::get<std::string>(owned.data[2]), "hello");
+}
+
+TEST(RelationCache, TestApplyAndReplaceRelation) {
+    events::RelationCache cache;
+    auto buffer =
+        buildRelation(16384, "users", { { "id", true }, { "name", false } });
+    const auto &result = TextContext::parseEvent(buffer);
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+    cache.apply(std::get<TextContext::events::Relation>(result.value()));
+
+    const auto &schema = cache.find(16384);
+    ASSERT_TRUE(schema.has_value());
+    EXPECT_EQ(schema->relationNamespace, "public");
+    EXPECT_EQ(schema->name, "users");
+    ASSERT_EQ(schema->columns.size(), 2);
+    EXPECT_EQ(schema->columns[1].name, "name");
+    EXPECT_EQ(schema->columns[1].oid, 25);
+    ASSERT_EQ(schema->keyColumns.size(), 1);
+    EXPECT_EQ(schema->keyColumns[0], 0);
+    EXPECT_EQ(schema->columnIndex("name"), 1);
+    EXPECT_FALSE(schema->columnIndex("email").has_value());
+    EXPECT_FALSE(cache.find(16385).has_value());
+
+    for (int index = 0; index < 4; index++) {
+        auto altered = buildRelation(
+            16384, "users",
+            { { "id", true }, { "name", false }, { "email", false } });
+        const auto &alteredResult = TextContext::parseEvent(altered);
+        ASSERT_TRUE(alteredResult.has_value())
+            << alteredResult.error().message();
+        cache.apply(
+            std::get<TextContext::events::Relation>(alteredResult.value()));
+    };
+    const auto &altered = cache.find(16384);
+    ASSERT_TRUE(altered.has_value());
+    EXPECT_EQ(cache.size(), 1);
+    ASSERT_EQ(altered->columns.size(), 3);
+    EXPECT_EQ(altered->columnIndex("email"), 2);
+    EXPECT_EQ(altered->keyColumns.size(), 1);
+
+    cache.erase(16384);
+    EXPECT_FALSE(cache.find(16384).has_value());
+    EXPECT_EQ(cache.size(), 0);
+
+    cache.apply(TextContext::events::Type{
+        .oid = 90000, .typeNamespace = "public", .name = "mood" });
+    cache.apply(TextContext::events::Type{
+        .oid = 90000, .typeNamespace = "public", .name = "feeling" });
+    ASSERT_TRUE(cache.findType(90000).has_value());
+    EXPECT_EQ(cache.findType(90000)->name, "feeling");
+}
+
+TEST(EventBatch, TestParseEventsReusesCapacity) {
+    auto insertBuffer = buildInsert(16384);
+    auto commitBuffer = buildCommit(100);
+    std::vector<char> invalidBuffer = { '?' };
+    std::vector<std::span<char>> messages = { insertBuffer, commitBuffer,
+                                              invalidBuffer, insertBuffer };
+
+    TextContext::EventBatch batch(8);
+    EXPECT_EQ(TextContext::parseEvents(messages, batch), 2);
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_TRUE(
+        std::holds_alternative<TextContext::events::Insert>(batch.events[0]));
+    EXPECT_TRUE(
+        std::holds_alternative<TextContext::events::Commit>(batch.events[1]));
+    ASSERT_FALSE(batch.ok());
+    EXPECT_EQ(batch.error->index, 2);
+
+    const auto &capacity = batch.events.capacity();
+    batch.clear();
+    EXPECT_TRUE(batch.ok());
+    EXPECT_EQ(batch.events.capacity(), capacity);
+    EXPECT_EQ(TextContext::parseEvents(std::span(messages).first(2), batch), 2);
+    EXPECT_EQ(batch.events.capacity(), capacity);
+}
+
+TEST(ParseError, TestErrorCarriesTypeAndOffset) {
+    std::vector<char> unknownBuffer = { '?' };
+    const auto &unknown = TextContext::parseEvent(unknownBuffer);
+    ASSERT_FALSE(unknown.has_value());
+    EXPECT_EQ(unknown.error().code, ParseErrorCode::UNEXPECTED_TYPE);
+    EXPECT_EQ(unknown.error().eventType, '?');
+    EXPECT_EQ(unknown.error().offset, 0);
+
+    auto commitBuffer = buildCommit(100);
+    commitBuffer.pop_back();
+    const auto &truncated = TextContext::parseEvent(commitBuffer);
+    ASSERT_FALSE(truncated.has_value());
+    EXPECT_EQ(truncated.error().code, ParseErrorCode::BUFFER_SIZE_MISMATCH);
+    EXPECT_EQ(truncated.error().eventType, 'C');
+    EXPECT_EQ(truncated.error().offset, 1);
+    EXPECT_EQ(truncated.error().expectedSize, events::Commit::bufferSize);
+    EXPECT_EQ(truncated.error().receivedSize, events::Commit::bufferSize - 1);
+    EXPECT_FALSE(truncated.error().message().empty());
+}
+
+TEST(EventDispatch, TestDispatchFollowsSessionOptions) {
+    using MessagesContext =
+        SessionContext<BinaryValue::OFF, MessagesValue::ON,
+                       StreamingValue::OFF, TwoPhaseValue::OFF,
+                       OriginValue::NONE>;
+    std::vector<char> buffer = { 'M', 1 };
+    appendInt64(buffer, 200);
+    appendString(buffer, "prefix");
+    appendInt32(buffer, 3);
+    buffer.insert(buffer.end(), { 'a', 'b', 'c' });
+
+    const auto &result = MessagesContext::parseEvent(buffer);
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+    const auto &message =
+        std::get<MessagesContext::events::Message>(result.value());
+    EXPECT_EQ(message.lsn, 200);
+    EXPECT_EQ(message.prefix, "prefix");
+    EXPECT_EQ(message.content.size(), 3);
+
+    const auto &disabled = TextContext::parseEvent(buffer);
+    ASSERT_FALSE(disabled.has_value());
+    EXPECT_EQ(disabled.error().code, ParseErrorCode::UNEXPECTED_TYPE);
+}
+
+TEST(Validation, TestHardenedRejectsOutOfBoundsLengths) {
+    auto truncated = buildInsert(16384);
+    truncated.resize(truncated.size() - 2);
+    const auto &tooShort = TextContext::parseEvent(truncated);
+    ASSERT_FALSE(tooShort.has_value());
+    EXPECT_EQ(tooShort.error().code, ParseErrorCode::BUFFER_TOO_SMALL);
+    EXPECT_EQ(tooShort.error().eventType, 'I');
+    EXPECT_EQ(tooShort.error().offset, 16);
+
+    auto negative = buildInsert(16384);
+    appendInt32(negative, 0);
+    std::fill_n(negative.begin() + 9, 4, '\xff');
+    const auto &negativeLength = TextContext::parseEvent(negative);
+    ASSERT_FALSE(negativeLength.has_value());
+    EXPECT_EQ(negativeLength.error().code, ParseErrorCode::INVALID_LENGTH);
+
+    auto binaryKind = buildInsert(16384);
+    binaryKind[8] = 'b';
+    const auto &wrongKind = TextContext::parseEvent(binaryKind);
+    ASSERT_FALSE(wrongKind.has_value());
+    EXPECT_EQ(wrongKind.error().code, ParseErrorCode::INVALID_VALUE);
+
+    auto relation = buildRelation(16384, "users", { { "id", true } });
+    relation.resize(23);
+    const auto &unterminated = TextContext::parseEvent(relation);
+    ASSERT_FALSE(unterminated.has_value());
+    EXPECT_EQ(unterminated.error().code,
+              ParseErrorCode::UNTERMINATED_STRING);
+    EXPECT_EQ(unterminated.error().offset, 22);
+
+    std::vector<char> empty;
+    EXPECT_EQ(TextContext::parseEvent(empty).error().code,
+              ParseErrorCode::EMPTY_MESSAGE);
+}
+
+TEST(Validation, TestTrustedParsesLikeHardened) {
+    auto buffer = buildInsert(16384);
+    const auto &result = TrustedTextContext::parseEvent(buffer);
+    ASSERT_TRUE(result.has_value());
+    const auto &insert =
+        std::get<TrustedTextContext::events::Insert>(result.value());
+    EXPECT_EQ(insert.oid, 16384);
+    ASSERT_EQ(insert.data.size(), 3);
+    EXPECT_EQ(std::get<std::string>(insert.data[2]), "hello");
+
+    auto relationBuffer = buildRelation(16384, "users", { { "id", true } });
+    const auto &relation = TrustedTextContext::parseEvent(relationBuffer);
+    ASSERT_TRUE(relation.has_value());
+    EXPECT_EQ(
+        std::get<TrustedTextContext::events::Relation>(relation.value()).name,
+        "users");
+}
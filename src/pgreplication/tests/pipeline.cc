@@ -0,0 +1,76 @@
+#include "../pgoutput/pipeline.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "../local_wal_sender.hpp"
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(ReplicationPipeline, TestDeliversEventsInOrder) {
+    using events = BorrowedTextContext::events;
+    LocalWalSender sender(7);
+    std::string applied;
+    ReplicationPipeline<BorrowedTextContext> pipeline(
+        [&sender](std::span<char> buffer) { return sender.read(buffer); },
+        [&applied](const BorrowedTextContext::Event &event) {
+            if (const auto *insert = std::get_if<events::Insert>(&event)) {
+                applied += std::get<std::string_view>(insert->data[2]);
+            } else if (std::holds_alternative<events::Commit>(event)) {
+                applied += ';';
+            };
+        },
+        128, 3);
+
+    std::string expected;
+    std::int64_t lsn = 0;
+    for (std::int32_t xid = 1; xid <= 50; xid++) {
+        auto begin = buildBegin(xid * 100, xid);
+        sender.send(begin, lsn++);
+        for (int index = 0; index < 3; index++) {
+            auto insert = buildInsert(16384);
+            sender.send(insert, lsn++);
+            expected += "hello";
+        };
+        auto commit = buildCommit(xid * 100);
+        sender.send(commit, lsn++);
+        expected += ';';
+        if (xid % 10 == 0) sender.sendKeepalive(xid * 1000, false);
+    };
+    sender.finish();
+    const auto &result = pipeline.wait();
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+
+    EXPECT_EQ(applied, expected);
+    EXPECT_EQ(pipeline.appliedLsn(), 5001);
+    EXPECT_EQ(pipeline.serverWalEnd(), 50000);
+    const auto &stats = pipeline.stats();
+    EXPECT_EQ(stats.receivedMessages, 250);
+    EXPECT_EQ(stats.appliedEvents, 250);
+    EXPECT_EQ(stats.parseQueueDepth, 0);
+    EXPECT_EQ(stats.applyQueueDepth, 0);
+
+    LocalWalSender oversized;
+    ReplicationPipeline<BorrowedTextContext> small(
+        [&oversized](std::span<char> buffer) {
+            return oversized.read(buffer);
+        },
+        [](const BorrowedTextContext::Event &) {}, 64, 2);
+    std::vector<char> message(100, 'M');
+    oversized.send(message, 0);
+    oversized.finish();
+    const auto &error = small.wait();
+    ASSERT_FALSE(error.has_value());
+    EXPECT_EQ(error.error().code, ParseErrorCode::MESSAGE_TOO_LARGE);
+}
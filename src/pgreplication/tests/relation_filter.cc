@@ -0,0 +1,67 @@
+#include "../pgoutput/relation_filter.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(RelationFilter, TestSkipsAndProjectsRelations) {
+    RelationFilter<TextContext> filter;
+    filter.allow("public", "users", { "id", "name" });
+    auto users = buildRelation(
+        16384, "users",
+        { { "id", true }, { "age", false }, { "name", false } });
+    auto orders = buildRelation(16385, "orders", { { "id", true } });
+    auto userInsert = buildInsert(16384);
+    auto orderInsert = buildInsert(16385);
+    std::vector<char> truncate = { 'T' };
+    appendInt32(truncate, 2);
+    truncate.push_back(0);
+    appendInt32(truncate, 16384);
+    appendInt32(truncate, 16385);
+
+    std::vector<std::span<char>> spans = { users, orders, userInsert,
+                                           orderInsert, truncate };
+    TextContext::EventBatch batch;
+    EXPECT_EQ(filter.parseEvents(spans, batch), 3);
+    ASSERT_TRUE(batch.ok()) << batch.error->error.message();
+    EXPECT_EQ(filter.skipped(), 2);
+    EXPECT_TRUE(filter.allowed(16384));
+    EXPECT_FALSE(filter.allowed(16385));
+
+    const auto &relation =
+        std::get<TextContext::events::Relation>(batch.events[0]);
+    ASSERT_EQ(relation.columns.size(), 2);
+    EXPECT_EQ(relation.columns[0].name, "id");
+    EXPECT_EQ(relation.columns[1].name, "name");
+    const auto &insert =
+        std::get<TextContext::events::Insert>(batch.events[1]);
+    ASSERT_EQ(insert.data.size(), 2);
+    EXPECT_EQ(std::get<std::string>(insert.data[0]), "42");
+    EXPECT_EQ(std::get<std::string>(insert.data[1]), "hello");
+    const auto &truncated =
+        std::get<TextContext::events::Truncate>(batch.events[2]);
+    EXPECT_EQ(truncated.oids, std::vector<std::int32_t>({ 16384 }));
+
+    RelationFilter<PackedTextContext> packedFilter;
+    packedFilter.allow("public", "users", { "name" });
+    ASSERT_TRUE(packedFilter.parseEvent(users).has_value());
+    const auto &packed = packedFilter.parseEvent(userInsert);
+    ASSERT_TRUE(packed.has_value()) << packed.error().message();
+    const auto &packedInsert =
+        std::get<PackedTextContext::events::Insert>(packed.value().value());
+    ASSERT_EQ(packedInsert.data.size(), 1);
+    EXPECT_EQ(std::get<std::string_view>(packedInsert.data[0]), "hello");
+}
@@ -0,0 +1,80 @@
+#include "../pgoutput/sharded_apply.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(ShardedApplyPipeline, TestKeepsPerKeyOrder) {
+    using events = TextContext::events;
+    constexpr std::int32_t keys = 8;
+    constexpr std::int32_t transactions = 20;
+    std::mutex mutex;
+    std::vector<std::vector<std::string>> versions(keys);
+    std::vector<std::vector<std::thread::id>> threads(keys);
+    ShardedApplyPipeline<TextContext> pipeline(
+        4,
+        [&](const TextContext::Event &event) {
+            const events::TupleData *data = nullptr;
+            if (const auto *insert = std::get_if<events::Insert>(&event)) {
+                data = &insert->data;
+            } else if (const auto *update =
+                           std::get_if<events::Update>(&event)) {
+                data = &update->data;
+            };
+            if (data == nullptr) return;
+            const auto &key = std::stoi(std::get<std::string>((*data)[0]));
+            std::lock_guard lock(mutex);
+            versions[key].emplace_back(std::get<std::string>((*data)[1]));
+            threads[key].push_back(std::this_thread::get_id());
+        },
+        4);
+
+    const auto &parse = [](std::vector<char> buffer) {
+        auto event = TextContext::parseEvent(buffer);
+        EXPECT_TRUE(event.has_value()) << event.error().message();
+        return std::move(event.value());
+    };
+    const auto &buildRow = [](char type, std::int32_t key,
+                              std::int32_t version) {
+        std::vector<char> buffer = { type };
+        appendInt32(buffer, 16384);
+        buffer.push_back('N');
+        appendInt16(buffer, 2);
+        appendTextColumn(buffer, std::to_string(key));
+        appendTextColumn(buffer, std::to_string(version));
+        return buffer;
+    };
+    pipeline.dispatch(parse(buildRelation(
+        16384, "users", { { "id", true }, { "version", false } })));
+    for (std::int32_t xid = 1; xid <= transactions; xid++) {
+        pipeline.dispatch(parse(buildBegin(xid * 100, xid)));
+        for (std::int32_t key = 0; key < keys; key++) {
+            pipeline.dispatch(parse(buildRow(xid == 1 ? 'I' : 'U', key, xid)));
+        };
+        pipeline.dispatch(parse(buildCommit(xid * 100)));
+    };
+    pipeline.drain();
+
+    EXPECT_EQ(pipeline.appliedLsn(), transactions * 100 + 1);
+    for (std::int32_t key = 0; key < keys; key++) {
+        ASSERT_EQ(versions[key].size(), transactions);
+        for (std::int32_t xid = 1; xid <= transactions; xid++) {
+            EXPECT_EQ(versions[key][xid - 1], std::to_string(xid));
+            EXPECT_EQ(threads[key][xid - 1], threads[key][0]);
+        };
+    };
+}
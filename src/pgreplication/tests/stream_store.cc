@@ -0,0 +1,99 @@
+#include "../pgoutput/stream_store.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+
+TEST(StreamedTransactionStore, TestSpillReplayAndSubTransactionAbort) {
+    const auto &directory =
+        std::filesystem::temp_directory_path() /
+        ("pgreplication_stream_store_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+    const auto &message = [](char tag) {
+        return std::vector<char>(16, tag);
+    };
+    {
+        StreamedTransactionStore store(directory, 64);
+        ASSERT_TRUE(store.append(10, 10, message('a')).has_value());
+        ASSERT_TRUE(store.append(20, 20, message('x')).has_value());
+        ASSERT_TRUE(store.append(10, 11, message('b')).has_value());
+        ASSERT_TRUE(store.append(10, 10, message('c')).has_value());
+        ASSERT_TRUE(store.append(10, 12, message('d')).has_value());
+        EXPECT_GT(store.spilledBytes(), 0);
+        EXPECT_LE(store.memoryUsage(), 64);
+
+        ASSERT_TRUE(store.abort(10, 12).has_value());
+        ASSERT_TRUE(store.append(10, 10, message('e')).has_value());
+        events::StreamAbort<StreamingValue::ON> abort = {
+            .transactionId = 20, .subTransactionId = 20 };
+        ASSERT_TRUE(store.abort(abort).has_value());
+        EXPECT_FALSE(store.contains(20));
+
+        std::string replayed;
+        const auto &result =
+            store.replay(10, [&replayed](std::span<char> buffer) {
+                EXPECT_EQ(buffer.size(), 16);
+                replayed.push_back(buffer[0]);
+            });
+        ASSERT_TRUE(result.has_value()) << result.error().message();
+        EXPECT_EQ(replayed, "abce");
+        EXPECT_EQ(store.size(), 0);
+        EXPECT_EQ(store.memoryUsage(), 0);
+        EXPECT_EQ(store.spilledBytes(), 0);
+
+        ASSERT_TRUE(store.append(30, 30, message('f')).has_value());
+        ASSERT_TRUE(store.append(30, 31, message('g')).has_value());
+        ASSERT_TRUE(store.append(30, 30, message('h')).has_value());
+        ASSERT_TRUE(store.append(30, 30, message('i')).has_value());
+        ASSERT_TRUE(store.abort(30, 31).has_value());
+        replayed.clear();
+        ASSERT_TRUE(store
+                        .replay(30,
+                                [&replayed](std::span<char> buffer) {
+                                    replayed.push_back(buffer[0]);
+                                })
+                        .has_value());
+        EXPECT_EQ(replayed, "f");
+    };
+    EXPECT_TRUE(std::filesystem::is_empty(directory));
+
+    // A spill directory below a regular file cannot be created.
+    const auto &blocked = directory / "file";
+    auto *file = std::fopen(blocked.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    std::fclose(file);
+    {
+        StreamedTransactionStore store(blocked / "spill", 32);
+        ASSERT_TRUE(store.append(40, 40, message('j')).has_value());
+        const auto &failed = store.append(40, 41, message('k'));
+        ASSERT_FALSE(failed.has_value());
+        EXPECT_EQ(failed.error(), std::errc::not_a_directory);
+        EXPECT_EQ(store.memoryUsage(), 20);
+        EXPECT_EQ(store.spilledBytes(), 0);
+
+        // Nothing of the failed message was kept, so aborting the
+        // subtransaction it would have started changes nothing.
+        ASSERT_TRUE(store.abort(40, 41).has_value());
+        std::string replayed;
+        ASSERT_TRUE(store
+                        .replay(40,
+                                [&replayed](std::span<char> buffer) {
+                                    replayed.push_back(buffer[0]);
+                                })
+                        .has_value());
+        EXPECT_EQ(replayed, "j");
+    };
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,89 @@
+#include "../pgoutput/text_decoders.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <variant>
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace std::chrono;
+
+class TextDecoders : public testing::TestWithParam<SimdLevel> {
+   protected:
+    void SetUp() override {
+        previous = textDecoderSimdLevel();
+        setTextDecoderSimdLevel(GetParam());
+    };
+    void TearDown() override { setTextDecoderSimdLevel(previous); };
+
+    SimdLevel previous;
+};
+
+TEST_P(TextDecoders, TestIntegers) {
+    EXPECT_EQ(decodeText<std::int16_t>("-32768").value(), -32768);
+    EXPECT_FALSE(decodeText<std::int16_t>("32768").has_value());
+    EXPECT_EQ(decodeText<std::int32_t>("2147483647").value(), 2147483647);
+    EXPECT_EQ(decodeText<std::int64_t>("1234567890123456").value(),
+              1234567890123456);
+    EXPECT_EQ(decodeText<std::int64_t>("-9223372036854775808").value(),
+              std::numeric_limits<std::int64_t>::min());
+    EXPECT_EQ(decodeText<std::int64_t>("0").value(), 0);
+    EXPECT_FALSE(decodeText<std::int32_t>("12a4").has_value());
+    EXPECT_FALSE(decodeText<std::int32_t>("-").has_value());
+    EXPECT_EQ(std::get<std::int32_t>(decodeText(23, "42").value()), 42);
+}
+
+TEST_P(TextDecoders, TestFloatAndBool) {
+    EXPECT_DOUBLE_EQ(decodeText<double>("-1.5e3").value(), -1500);
+    EXPECT_TRUE(std::isnan(decodeText<double>("NaN").value()));
+    EXPECT_TRUE(std::isinf(decodeText<double>("-Infinity").value()));
+    EXPECT_TRUE(decodeText<bool>("t").value());
+    EXPECT_FALSE(decodeText<bool>("f").value());
+    EXPECT_FALSE(decodeText<bool>("x").has_value());
+}
+
+TEST_P(TextDecoders, TestDateAndTimestamp) {
+    EXPECT_EQ(decodeText<Date>("2024-02-29").value(),
+              sys_days(2024y / February / 29));
+    EXPECT_FALSE(decodeText<Date>("2023-02-29").has_value());
+    EXPECT_EQ(decodeText<Date>("12345-01-01").value(),
+              sys_days(year(12345) / January / 1));
+    EXPECT_EQ(decodeText<Date>("0044-03-15 BC").value(),
+              sys_days(year(-43) / March / 15));
+
+    const auto &base = Timestamp(sys_days(2024y / January / 2));
+    EXPECT_EQ(decodeText<Timestamp>("2024-01-02 03:04:05").value(),
+              base + 3h + 4min + 5s);
+    EXPECT_EQ(decodeText<Timestamp>("2024-01-02 03:04:05.12").value(),
+              base + 3h + 4min + 5s + 120000us);
+    EXPECT_EQ(decodeText<Timestamp>("2024-01-02 03:04:05.000001+05:30")
+                  .value(),
+              base + 3h + 4min + 5s + 1us - 5h - 30min);
+    EXPECT_EQ(decodeText<Timestamp>("2024-01-02 03:04:05-08").value(),
+              base + 11h + 4min + 5s);
+    EXPECT_EQ(decodeText<Timestamp>("infinity").value(), Timestamp::max());
+    EXPECT_FALSE(decodeText<Timestamp>("2024-01-02T03:04:05").has_value());
+    EXPECT_FALSE(decodeText<Timestamp>("2024-01-02 03:04").has_value());
+}
+
+TEST_P(TextDecoders, TestUuid) {
+    const auto &uuid =
+        decodeText<Uuid>("a0eebc99-9C0B-4ef8-bb6d-6bb9bd380a11");
+    ASSERT_TRUE(uuid.has_value()) << uuid.error().message();
+    EXPECT_EQ(uuid.value()[0], std::byte{ 0xa0 });
+    EXPECT_EQ(uuid.value()[4], std::byte{ 0x9c });
+    EXPECT_EQ(uuid.value()[15], std::byte{ 0x11 });
+    EXPECT_FALSE(
+        decodeText<Uuid>("a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a1g").has_value());
+}
+
+INSTANTIATE_TEST_SUITE_P(SimdLevels, TextDecoders,
+                         testing::Values(SimdLevel::SCALAR, SimdLevel::SSE42,
+                                         SimdLevel::AVX2));
@@ -0,0 +1,59 @@
+#include "../pgoutput/transaction.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utility>
+#include <variant>
+
+#include "./contexts.hpp"
+#include "./wire.hpp"
+
+using namespace PGREPLICATION_NAMESPACE;
+using namespace PGREPLICATION_NAMESPACE::pgoutput;
+using namespace PGREPLICATION_NAMESPACE::tests;
+
+TEST(TransactionAssembler, TestAssemblesAndReusesStorage) {
+    TransactionAssembler<TextContext> assembler(4);
+    auto insertBuffer = buildInsert(16384);
+    auto commitBuffer = buildCommit(100);
+
+    for (std::int32_t xid = 1; xid <= 2; xid++) {
+        auto beginBuffer = buildBegin(100, xid);
+        auto begin = TextContext::parseEvent(beginBuffer);
+        ASSERT_TRUE(begin.has_value()) << begin.error().message();
+        ASSERT_TRUE(assembler.push(std::move(begin.value())).has_value());
+        EXPECT_TRUE(assembler.inTransaction());
+        for (int index = 0; index < 3; index++) {
+            auto insert = TextContext::parseEvent(insertBuffer);
+            ASSERT_TRUE(insert.has_value()) << insert.error().message();
+            const auto &pushed = assembler.push(std::move(insert.value()));
+            ASSERT_TRUE(pushed.has_value());
+            EXPECT_EQ(pushed.value(), nullptr);
+        };
+        EXPECT_EQ(assembler.pendingChanges(), 3);
+
+        auto commit = TextContext::parseEvent(commitBuffer);
+        ASSERT_TRUE(commit.has_value()) << commit.error().message();
+        const auto &result = assembler.push(std::move(commit.value()));
+        ASSERT_TRUE(result.has_value()) << result.error().message();
+        const auto *transaction = result.value();
+        ASSERT_NE(transaction, nullptr);
+        EXPECT_EQ(transaction->transactionId(), xid);
+        EXPECT_EQ(transaction->endLsn(), 101);
+        ASSERT_EQ(transaction->changes.size(), 3);
+        EXPECT_TRUE(std::holds_alternative<TextContext::events::Insert>(
+            transaction->changes[0]));
+        EXPECT_GE(transaction->changes.capacity(), 4);
+        EXPECT_FALSE(assembler.inTransaction());
+    };
+    EXPECT_EQ(assembler.lastCommittedEndLsn(), 101);
+
+    auto commit = TextContext::parseEvent(commitBuffer);
+    ASSERT_TRUE(commit.has_value());
+    const auto &unmatched = assembler.push(std::move(commit.value()));
+    ASSERT_FALSE(unmatched.has_value());
+    EXPECT_EQ(unmatched.error().code, ParseErrorCode::UNEXPECTED_EVENT);
+    EXPECT_EQ(unmatched.error().eventType, 'C');
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../utils.hpp"
+
+// Builders for the pgoutput messages the tests parse, in their wire format.
+namespace PGREPLICATION_NAMESPACE::tests {
+using utils::appendInt16;
+using utils::appendInt32;
+using utils::appendInt64;
+
+inline void appendString(std::vector<char> &buffer, std::string_view value) {
+    buffer.insert(buffer.end(), value.begin(), value.end());
+    buffer.push_back('\0');
+};
+
+inline void appendTextColumn(std::vector<char> &buffer,
+                             std::string_view value) {
+    buffer.push_back('t');
+    appendInt32(buffer, value.size());
+    buffer.insert(buffer.end(), value.begin(), value.end());
+};
+
+// An Insert of ('42', NULL, 'hello').
+inline std::vector<char> buildInsert(std::int32_t oid) {
+    std::vector<char> buffer = { 'I' };
+    appendInt32(buffer, oid);
+    buffer.push_back('N');
+    appendInt16(buffer, 3);
+    appendTextColumn(buffer, "42");
+    buffer.push_back('n');
+    appendTextColumn(buffer, "hello");
+    return buffer;
+};
+
+// A Relation in the public schema whose columns are all text.
+inline std::vector<char> buildRelation(
+    std::int32_t oid, std::string_view name,
+    const std::vector<std::pair<std::string_view, bool>> &columns) {
+    std::vector<char> buffer = { 'R' };
+    appendInt32(buffer, oid);
+    appendString(buffer, "public");
+    appendString(buffer, name);
+    buffer.push_back('d');
+    appendInt16(buffer, columns.size());
+    for (const auto &[columnName, isKey] : columns) {
+        buffer.push_back(isKey ? 1 : 0);
+        appendString(buffer, columnName);
+        appendInt32(buffer, 25);
+        appendInt32(buffer, -1);
+    };
+    return buffer;
+};
+
+inline std::vector<char> buildBegin(std::int64_t lsn, std::int32_t xid) {
+    std::vector<char> buffer = { 'B' };
+    appendInt64(buffer, lsn);
+    appendInt64(buffer, 0);
+    appendInt32(buffer, xid);
+    return buffer;
+};
+
+inline std::vector<char> buildCommit(std::int64_t lsn) {
+    std::vector<char> buffer = { 'C', 0 };
+    appendInt64(buffer, lsn);
+    appendInt64(buffer, lsn + 1);
+    appendInt64(buffer, 0);
+    return buffer;
+};
+
+inline std::vector<char> buildOrigin(std::int64_t lsn, std::string_view name) {
+    std::vector<char> buffer = { 'O' };
+    appendInt64(buffer, lsn);
+    appendString(buffer, name);
+    return buffer;
+};
+};  // namespace PGREPLICATION_NAMESPACE::tests
@@ -3,28 +3,37 @@
 #include <bit>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <format>
+#include <span>
 #include <stdexcept>
+#include <vector>
 
 namespace PGREPLICATION_NAMESPACE::utils {
-std::int64_t int64FromNetwork(const type_span<std::int64_t> &buffer) {
-    const auto &value = *(std::int64_t *)buffer.data();
+std::int64_t int64FromNetwork(
+    const const_type_span<std::int64_t> &buffer) {
+    std::int64_t value;
+    std::memcpy(&value, buffer.data(), sizeof(value));
     if constexpr (std::endian::native == std::endian::big) {
         return value;
     };
     return std::byteswap(value);
 };
 
-std::int32_t int32FromNetwork(const type_span<std::int32_t> &buffer) {
-    const auto &value = *(std::int32_t *)buffer.data();
+std::int32_t int32FromNetwork(
+    const const_type_span<std::int32_t> &buffer) {
+    std::int32_t value;
+    std::memcpy(&value, buffer.data(), sizeof(value));
     if constexpr (std::endian::native == std::endian::big) {
         return value;
     };
     return std::byteswap(value);
 };
 
-std::int16_t int16FromNetwork(const type_span<std::int16_t> &buffer) {
-    const auto &value = *(std::int16_t *)buffer.data();
+std::int16_t int16FromNetwork(
+    const const_type_span<std::int16_t> &buffer) {
+    std::int16_t value;
+    std::memcpy(&value, buffer.data(), sizeof(value));
     if constexpr (std::endian::native == std::endian::big) {
         return value;
     };
@@ -59,7 +68,33 @@ void int32ToNetwork(const type_span<std::int32_t> &buffer, std::int32_t n) {
     };
 };
 
+void int16ToNetwork(const type_span<std::int16_t> &buffer, std::int16_t n) {
+    if constexpr (std::endian::native == std::endian::big) {
+        *(std::uint16_t *)buffer.data() = n;
+    } else {
+        *(std::uint16_t *)buffer.data() = std::byteswap(n);
+    };
+};
+
 void boolToNetwork(const type_span<bool> &buffer, bool value) {
     *buffer.data() = value ? 1 : 0;
 };
+
+void appendInt64(std::vector<char> &buffer, std::int64_t n) {
+    const auto &offset = buffer.size();
+    buffer.resize(offset + sizeof(n));
+    int64ToNetwork(std::span(buffer).subspan(offset).first<sizeof(n)>(), n);
+};
+
+void appendInt32(std::vector<char> &buffer, std::int32_t n) {
+    const auto &offset = buffer.size();
+    buffer.resize(offset + sizeof(n));
+    int32ToNetwork(std::span(buffer).subspan(offset).first<sizeof(n)>(), n);
+};
+
+void appendInt16(std::vector<char> &buffer, std::int16_t n) {
+    const auto &offset = buffer.size();
+    buffer.resize(offset + sizeof(n));
+    int16ToNetwork(std::span(buffer).subspan(offset).first<sizeof(n)>(), n);
+};
 };  // namespace PGREPLICATION_NAMESPACE::utils
@@ -13,13 +13,20 @@
 namespace PGREPLICATION_NAMESPACE::utils {
 template <typename T>
 using type_span = std::span<char, sizeof(T)>;
-std::int64_t int64FromNetwork(const type_span<std::int64_t> &buffer);
-std::int32_t int32FromNetwork(const type_span<std::int32_t> &buffer);
-std::int16_t int16FromNetwork(const type_span<std::int16_t> &buffer);
+template <typename T>
+using const_type_span = std::span<const char, sizeof(T)>;
+std::int64_t int64FromNetwork(const const_type_span<std::int64_t> &buffer);
+std::int32_t int32FromNetwork(const const_type_span<std::int32_t> &buffer);
+std::int16_t int16FromNetwork(const const_type_span<std::int16_t> &buffer);
 bool boolFromNetwork(const char c);
 void int64ToNetwork(const type_span<std::int64_t> &buffer, std::int64_t n);
 void int32ToNetwork(const type_span<std::int32_t> &buffer, std::int32_t n);
+void int16ToNetwork(const type_span<std::int16_t> &buffer, std::int16_t n);
 void boolToNetwork(const type_span<bool> &buffer, bool value);
+// Grow buffer by the network encoding of n, for building wire messages.
+void appendInt64(std::vector<char> &buffer, std::int64_t n);
+void appendInt32(std::vector<char> &buffer, std::int32_t n);
+void appendInt16(std::vector<char> &buffer, std::int16_t n);
 
 template <class... Ts>
 struct overloaded : Ts... {
@@ -79,15 +86,15 @@ struct formatter<variant<Ts...>> {
 };
 #endif
 
-template <>
-struct formatter<vector<byte>> {
+template <typename Allocator>
+struct formatter<vector<byte, Allocator>> {
     template <typename ParseContext>
     constexpr auto parse(ParseContext &ctx) {
         return ctx.begin();
     }
 
     template <typename FormatContext>
-    auto format(const std::vector<std::byte> &record,
+    auto format(const std::vector<std::byte, Allocator> &record,
                 FormatContext &ctx) const {
         return std::format_to(ctx.out(), "{}",
                               std::span<unsigned char>(